@@ -2,6 +2,72 @@
 
 // copy the following code to coursemology without the above line of "#include "LinkedList.h""
 
+// Returns every chunk at once; nodes hold plain ints so nothing else to destroy
+NodePool::~NodePool() {
+	while (m_chunks != nullptr) {
+		Chunk* chunk = m_chunks;
+		m_chunks = m_chunks->next;
+		delete chunk;
+	}
+}
+
+// Takes a slot from the free list, or from the newest chunk if none is free
+Node* NodePool::create(int element, Node* next) {
+	void* slot;
+	if (m_free != nullptr) {
+		slot = m_free;
+		m_free = m_free->next;
+	}
+	else {
+		if (m_chunks == nullptr || m_bump == NODES_PER_CHUNK) {	//newest chunk is used up
+			Chunk* chunk = new Chunk;
+			chunk->next = m_chunks;
+			m_chunks = chunk;
+			m_bump = 0;
+		}
+		slot = m_chunks->slots[m_bump++];
+	}
+	return new (slot) Node(element, next);
+}
+
+// Puts the node's slot back on the free list
+void NodePool::destroy(Node* node) {
+	m_free = new (node) FreeSlot{ m_free };				//reuse the node storage as a free list link
+}
+
+void NodePool::swap(NodePool& other) {
+	std::swap(m_chunks, other.m_chunks);
+	std::swap(m_bump, other.m_bump);
+	std::swap(m_free, other.m_free);
+}
+
+// Copies every node of other, keeping the order
+List::List(const List& other) : m_size{ 0 }, m_head{ nullptr } {
+	Node* tail = nullptr;								//track last node of new list
+	for (Node* currentNode = other.m_head; currentNode != nullptr; currentNode = currentNode->next) {
+		Node* newNode = m_pool.create(currentNode->element, nullptr);
+		if (tail == nullptr) {
+			m_head = newNode;
+		}
+		else {
+			tail->next = newNode;
+		}
+		tail = newNode;
+		m_size++;
+	}
+}
+
+// Copy-and-swap: the old nodes go away with temp's pool
+List& List::operator=(const List& other) {
+	if (this != &other) {
+		List temp(other);
+		std::swap(m_head, temp.m_head);
+		std::swap(m_size, temp.m_size);
+		m_pool.swap(temp.m_pool);
+	}
+	return *this;
+}
+
 // Returns the value at head
 int List::head() {
 	if (empty()) {
@@ -22,8 +88,7 @@ size_t List::size() const {
 
 // Inserts an element/new node to the head
 void List::push_head(int element) {
-	Node* aNewNode = new Node(element);					//create new node
-	aNewNode->next = m_head;							//new node points to node 1
+	Node* aNewNode = m_pool.create(element, m_head);	//create new node pointing to node 1
 	m_head = aNewNode;									//head points to new node
 	m_size++;											//update size
 }
@@ -36,7 +101,7 @@ int List::pop_head() {
 	int value_in_Node = m_head->element;				//need to return the head's value
 	Node* temp = m_head;								//to not lose the current head
 	m_head = m_head->next;								//to link to next node
-	delete temp;										//free the memory
+	m_pool.destroy(temp);								//return the node to the pool
 	m_size--;											//update size
 	return value_in_Node;
 }
@@ -53,22 +118,53 @@ bool List::contains(int element) const {
 	return false;
 }
 
-// Returns a std::string equivalent of the container
-std::string List::to_string() const {
-	if (empty()) {										//check for exception of empty list
-		return "{}";
+// Longest int in decimal: sign and 10 digits
+static const size_t MAX_INT_CHARS = 11;
+
+// Exact number of characters to_string() produces
+size_t List::string_length() const {
+	if (empty()) {
+		return 2;
+	}
+	size_t length = 2 + 2 * (m_size - 1);				//braces and ", " separators
+	char buffer[MAX_INT_CHARS];
+	for (Node* currentNode = m_head; currentNode != nullptr; currentNode = currentNode->next) {
+		length += std::to_chars(buffer, buffer + MAX_INT_CHARS, currentNode->element).ptr - buffer;
 	}
+	return length;
+}
 
-	Node* currentNode = m_head;
-	std::string answer = "{";
-	
-	while (currentNode != nullptr) {
-		answer += std::to_string(currentNode->element); //convert from int to string and append
+// Writes to_string() into a buffer of at least string_length() chars
+char* List::write_to(char* out) const {
+	*out++ = '{';
+	for (Node* currentNode = m_head; currentNode != nullptr; currentNode = currentNode->next) {
+		out = std::to_chars(out, out + MAX_INT_CHARS, currentNode->element).ptr;
 		if (currentNode->next != nullptr) {				//check to ensure it is not the last node
-			answer += ", ";								//requires space and comma
+			*out++ = ',';
+			*out++ = ' ';
+		}
+	}
+	*out++ = '}';
+	return out;
+}
+
+// Streams to_string() into os without building the whole string
+std::ostream& List::write_to(std::ostream& os) const {
+	char buffer[MAX_INT_CHARS];
+	os.put('{');
+	for (Node* currentNode = m_head; currentNode != nullptr; currentNode = currentNode->next) {
+		os.write(buffer, std::to_chars(buffer, buffer + MAX_INT_CHARS, currentNode->element).ptr - buffer);
+		if (currentNode->next != nullptr) {
+			os.write(", ", 2);
 		}
-		currentNode = currentNode->next;
 	}
-	answer += "}";
+	os.put('}');
+	return os;
+}
+
+// Returns a std::string equivalent of the container, allocated once at its exact size
+std::string List::to_string() const {
+	std::string answer(string_length(), '\0');
+	write_to(&answer[0]);
 	return answer;
 }
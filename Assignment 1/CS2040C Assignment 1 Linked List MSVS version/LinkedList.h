@@ -2,8 +2,13 @@
 #ifndef LINKED_LIST_H
 #define LINKED_LIST_H
 
+#include <charconv>
 #include <initializer_list>
+#include <new>
+#include <ostream>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
 struct Node {
     int element;
@@ -13,10 +18,49 @@ struct Node {
     Node(int element, Node* next) : element{ element }, next{ next } {}
 };
 
+// Per-list node allocator: hands out nodes from chunks of many slots and
+// keeps released nodes on an intrusive free list for reuse
+class NodePool {
+private:
+    static const size_t NODES_PER_CHUNK = 64;
+
+    // A released slot reuses its storage to point at the next free slot
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    struct Chunk {
+        Chunk* next;
+        alignas(Node) unsigned char slots[NODES_PER_CHUNK][sizeof(Node)];
+    };
+
+    Chunk* m_chunks;
+    size_t m_bump;
+    FreeSlot* m_free;
+
+public:
+    NodePool() : m_chunks{ nullptr }, m_bump{ 0 }, m_free{ nullptr } {}
+
+    // Returns every chunk at once
+    ~NodePool();
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // Constructs a node in a free slot
+    Node* create(int element, Node* next);
+
+    // Puts the node's slot back on the free list
+    void destroy(Node* node);
+
+    void swap(NodePool& other);
+};
+
 class List {
 private:
     size_t m_size;
     Node* m_head;
+    NodePool m_pool;
 
 public:
     // Constructs an empty container
@@ -31,6 +75,15 @@ public:
         push_head(*it);
     }
 
+    // Destructor (the pool frees all nodes in one go)
+    ~List() = default;
+
+    // Copy constructor
+    List(const List& other);
+
+    // Copy assignment
+    List& operator=(const List& other);
+
     // Returns the value at head
     int head();
 
@@ -49,6 +102,15 @@ public:
     // Checks whether the container contains the specified element
     bool contains(int element) const;
 
+    // Exact number of characters to_string() produces
+    size_t string_length() const;
+
+    // Writes to_string() into a buffer of at least string_length() chars, returns the end
+    char* write_to(char* out) const;
+
+    // Streams to_string() into os
+    std::ostream& write_to(std::ostream& os) const;
+
     // Converts the container to std::string
     std::string to_string() const;
 };
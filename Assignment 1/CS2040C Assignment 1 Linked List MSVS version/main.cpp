@@ -3,15 +3,17 @@
 #include <iostream>
 #include "LinkedList.h"
 #include <cassert>
+#include <chrono>
 
 void push_head_test1();
 void pop_head_test1();
+void push_pop_benchmark();
 
 int main()
 {
     push_head_test1();
     pop_head_test1();
-
+    push_pop_benchmark();
 
     // you should write more test cases for yourself
 }
@@ -53,3 +55,46 @@ void pop_head_test1()
     {6, 2, 9, 5, 1, 4, 1, 3}
     */
 }
+
+
+void push_pop_benchmark()
+{
+    std::cout << "push_pop_benchmark()" << std::endl;
+    const int ROUNDS = 100;
+    const int DEPTH = 10000;
+    typedef std::chrono::steady_clock Clock;
+
+    // new/delete per node, as push_head/pop_head did before the node pool
+    Clock::time_point start = Clock::now();
+    Node* stack = nullptr;
+    long long checksum = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < DEPTH; i++) {
+            stack = new Node(i, stack);
+        }
+        while (stack != nullptr) {
+            Node* node = stack;
+            stack = stack->next;
+            checksum += node->element;
+            delete node;
+        }
+    }
+    double newDeleteMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    List list;
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < DEPTH; i++) {
+            list.push_head(i);
+        }
+        while (!list.empty()) {
+            checksum -= list.pop_head();
+        }
+    }
+    double pooledMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    const double ops = 2.0 * ROUNDS * DEPTH;
+    std::cout << "new/delete: " << ops / newDeleteMs / 1000 << " Mops/s" << std::endl;
+    std::cout << "pooled:     " << ops / pooledMs / 1000 << " Mops/s" << std::endl;
+    assert(checksum == 0);
+}
\ No newline at end of file
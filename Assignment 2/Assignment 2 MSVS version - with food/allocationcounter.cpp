@@ -0,0 +1,40 @@
+#include "allocationcounter.h"
+#include <cstdlib>
+#include <new>
+
+// Innermost counter in scope on this thread, if any
+static thread_local AllocationCounter* t_counter = nullptr;
+
+AllocationCounter::AllocationCounter() : m_outer{ t_counter }, m_count{ 0 }
+{
+    t_counter = this;
+}
+
+AllocationCounter::~AllocationCounter()
+{
+    t_counter = m_outer;
+}
+
+// The replacements live in their own translation unit so callers can't see
+// malloc and free through them; the compiler would flag every inlined
+// operator delete as freeing memory that came from operator new
+void* operator new(size_t size)
+{
+    if (t_counter != nullptr) {
+        t_counter->m_count++;
+    }
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+
+// Counts the heap allocations the current thread makes while it is alive.
+// operator new is replaced in allocationcounter.cpp, but it only bumps a
+// counter when the calling thread has an AllocationCounter in scope, so code
+// that isn't measuring allocations pays a thread-local check and shares
+// nothing between threads. Counters nest; only the innermost one counts.
+class AllocationCounter {
+public:
+    AllocationCounter();
+    ~AllocationCounter();
+
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    // Allocations made on this thread since the counter was created
+    size_t count() const { return m_count; }
+
+private:
+    friend void* operator new(size_t size);
+
+    AllocationCounter* m_outer;
+    size_t m_count;
+};
@@ -0,0 +1,87 @@
+#include "combo.h"
+#include <utility>
+#include <vector>
+
+// Frees the children this node owns alone with an explicit stack, detaching
+// each one's children before it goes, so dropping a long fold can't
+// overflow the call stack either
+Combo::Rope::~Rope()
+{
+    auto owned = [](const std::shared_ptr<const Rope>& rope) { return rope && rope.use_count() == 1; };
+    if (!owned(left) && !owned(right)) {
+        return;                                     // leaves, and nodes whose children are shared
+    }
+    std::vector<std::shared_ptr<const Rope>> pending;
+    pending.push_back(std::move(left));
+    pending.push_back(std::move(right));
+    while (!pending.empty()) {
+        std::shared_ptr<const Rope> rope = std::move(pending.back());
+        pending.pop_back();
+        if (owned(rope)) {
+            Rope& node = const_cast<Rope&>(*rope);  // created non-const, and this is the last reference
+            pending.push_back(std::move(node.left));
+            pending.push_back(std::move(node.right));
+        }
+    }                                               // rope is freed here, childless
+}
+
+// A leaf for food's name, without copying it
+Combo::Combo(const Food& food)
+    : Combo(std::make_shared<Rope>(food.shared_name(), nullptr, nullptr), food.shared_name() ? food.shared_name()->size() : 0,
+            food.calories())
+{
+}
+
+// Walks the rope in order with an explicit stack, so long folds can't overflow the call stack.
+// A pending entry is either a node to expand or, when the node is null, text to append.
+std::string Combo::name() const
+{
+    static const std::string SEPARATOR = " ";
+    std::string name;
+    name.reserve(m_length);
+    std::vector<std::pair<const Rope*, const std::string*>> pending{ { m_rope.get(), nullptr } };
+    while (!pending.empty()) {
+        const Rope* node = pending.back().first;
+        const std::string* text = pending.back().second;
+        pending.pop_back();
+        if (node == nullptr) {
+            if (text != nullptr) name += *text;
+        }
+        else if (!node->left) {
+            if (node->text) name += *node->text;
+        }
+        else {
+            if (node->right) {
+                pending.emplace_back(node->right.get(), nullptr);
+            }
+            else {
+                pending.emplace_back(nullptr, node->text.get());
+            }
+            pending.emplace_back(nullptr, &SEPARATOR);
+            pending.emplace_back(node->left.get(), nullptr);
+        }
+    }
+    return name;
+}
+
+Combo Combo::operator+(const Combo& rhs) const
+{
+    std::shared_ptr<const Rope> joined = std::make_shared<Rope>(nullptr, m_rope, rhs.m_rope);
+    return Combo(joined, m_length + 1 + rhs.m_length, m_calories + rhs.m_calories);
+}
+
+// One node holding the food's name next to this combo's rope, instead of a leaf plus a join
+Combo Combo::operator+(const Food& rhs) const
+{
+    const std::shared_ptr<const std::string>& text = rhs.shared_name();
+    std::shared_ptr<const Rope> appended = std::make_shared<Rope>(text, m_rope, nullptr);
+    return Combo(appended, m_length + 1 + (text ? text->size() : 0), m_calories + rhs.calories());
+}
+
+bool Combo::operator==(const Combo& rhs) const
+{
+    if (m_calories != rhs.m_calories || m_length != rhs.m_length) {
+        return false;
+    }
+    return m_rope == rhs.m_rope || name() == rhs.name();
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <memory>
+#include <string>
+#include "food.h"
+
+// A meal folded from Food with operator+. Calories are summed as items are
+// added, the same way Food::operator+ sums them. The name is kept as a rope
+// whose leaves share each Food's name string, so adding an item to a combo
+// links one rope node and copies no text: folding n items costs O(n)
+// instead of copying the growing name every time. The full name string is
+// only built when name() is called, and not cached, so a const Combo can be
+// shared between threads.
+class Combo {
+private:
+    // A leaf when left is empty: just text. Otherwise left + " " + right,
+    // or left + " " + text when right is empty (an item added to a combo).
+    // Ropes are created non-const and only shared as const, so the
+    // destructor may take apart children nobody else holds.
+    struct Rope {
+        std::shared_ptr<const std::string> text;
+        std::shared_ptr<const Rope> left;
+        std::shared_ptr<const Rope> right;
+
+        Rope(std::shared_ptr<const std::string> text, std::shared_ptr<const Rope> left, std::shared_ptr<const Rope> right)
+            : text{ std::move(text) }, left{ std::move(left) }, right{ std::move(right) } {}
+        ~Rope();
+    };
+
+    std::shared_ptr<const Rope> m_rope;
+    size_t m_length;                 // length of the full name
+    float m_calories;
+
+    Combo(std::shared_ptr<const Rope> rope, size_t length, float calories)
+        : m_rope{ std::move(rope) }, m_length{ length }, m_calories{ calories } {}
+
+public:
+    Combo(const Food& food);
+
+    // Builds the full name, as Food::operator+ would have
+    std::string name() const;
+
+    size_t name_length() const { return m_length; }
+
+    float calories() const { return m_calories; }
+
+    // Same result as folding the components with Food::operator+
+    Food to_food() const { return Food(name(), m_calories); }
+
+    Combo operator+(const Combo& rhs) const;
+    Combo operator+(const Food& rhs) const;
+
+    bool operator<(const Combo& rhs) const { return m_calories < rhs.m_calories; }
+
+    bool operator==(const Combo& rhs) const;
+};
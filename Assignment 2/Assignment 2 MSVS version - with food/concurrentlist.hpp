@@ -0,0 +1,224 @@
+#ifndef CONCURRENT_LIST_H
+#define CONCURRENT_LIST_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+template <typename T> struct StackNode {
+  T element;
+  StackNode<T> *next;         // never changes once pushed, so readers can keep walking a popped node
+  StackNode<T> *retired_next; // chain of popped nodes waiting to be freed
+
+  StackNode(const T &element) : element{element}, next{nullptr}, retired_next{nullptr} {}
+};
+
+// Lock-free stack with the head/push_head/pop_head/contains API of List<T>.
+// push_head/pop_head are a CAS loop on m_head (Treiber stack). Popped nodes
+// are reclaimed with epochs: every operation that dereferences nodes
+// announces the global epoch in a slot, and a node popped in epoch e is only
+// freed once the global epoch reaches e + 2, which cannot happen while any
+// thread that might still see the node is inside its operation. Because a
+// node's address is never reused while someone can still hold it, the head
+// CAS is also safe from ABA.
+template <typename T> class ConcurrentList {
+private:
+  static const size_t SLOTS = 128;            // concurrent operations before threads spin for a slot
+  static const size_t RECLAIM_THRESHOLD = 64; // retired nodes per slot between attempts to move the epoch
+
+  // One operation in flight. state is 0 when free, otherwise (epoch << 1) | 1.
+  // The retired nodes belong to whoever holds the slot, in three lists by
+  // epoch % 3; a list holds the nodes of a single epoch, retired_epoch[i],
+  // so it is freed whole.
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> state;
+    StackNode<T> *retired[3];
+    uint64_t retired_epoch[3];
+    size_t retired_since_reclaim;
+
+    Slot() : state{0}, retired{nullptr, nullptr, nullptr}, retired_epoch{0, 0, 0}, retired_since_reclaim{0} {}
+  };
+
+  std::atomic<StackNode<T> *> m_head;
+  std::atomic<size_t> m_size;
+  std::atomic<uint64_t> m_epoch;
+  Slot m_slots[SLOTS];
+
+  // Holds a slot for the duration of one operation
+  class Guard {
+  public:
+    Guard(ConcurrentList<T> &list) {
+      size_t index = std::hash<std::thread::id>()(std::this_thread::get_id()) % SLOTS;
+      for (;;) {
+        uint64_t expected = 0;
+        uint64_t announced = (list.m_epoch.load() << 1) | 1;
+        if (list.m_slots[index].state.compare_exchange_strong(expected, announced)) {
+          m_slot = &list.m_slots[index];
+          return;
+        }
+        index = (index + 1) % SLOTS;
+      }
+    }
+
+    ~Guard() { m_slot->state.store(0); }
+
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+
+    Slot &slot() { return *m_slot; }
+
+  private:
+    Slot *m_slot;
+  };
+
+  // Moves the global epoch forward if every operation in flight has seen it
+  void try_advance_epoch() {
+    uint64_t epoch = m_epoch.load();
+    for (size_t i = 0; i < SLOTS; i++) {
+      uint64_t state = m_slots[i].state.load();
+      if ((state & 1) != 0 && (state >> 1) != epoch) {
+        return;
+      }
+    }
+    m_epoch.compare_exchange_strong(epoch, epoch + 1);
+  }
+
+  static void free_retired(StackNode<T> *node) {
+    while (node != nullptr) {
+      StackNode<T> *next = node->retired_next;
+      delete node;
+      node = next;
+    }
+  }
+
+  // Queues a popped node on the guard's slot. A list that still holds an
+  // older epoch with the same residue was retired at least three epochs ago
+  // and is freed first. Every RECLAIM_THRESHOLD nodes, tries to move the
+  // epoch forward and frees the lists two epochs behind: O(SLOTS) per
+  // attempt, whether or not a stalled thread holds the epoch back.
+  void retire(Guard &guard, StackNode<T> *node) {
+    Slot &slot = guard.slot();
+    uint64_t epoch = m_epoch.load();
+    size_t list = epoch % 3;
+    if (slot.retired_epoch[list] != epoch) {
+      free_retired(slot.retired[list]);
+      slot.retired[list] = nullptr;
+      slot.retired_epoch[list] = epoch;
+    }
+    node->retired_next = slot.retired[list];
+    slot.retired[list] = node;
+    if (++slot.retired_since_reclaim < RECLAIM_THRESHOLD) {
+      return;
+    }
+
+    slot.retired_since_reclaim = 0;
+    try_advance_epoch();
+    epoch = m_epoch.load();
+    for (list = 0; list < 3; list++) {
+      if (slot.retired_epoch[list] + 2 <= epoch) {
+        free_retired(slot.retired[list]);
+        slot.retired[list] = nullptr;
+      }
+    }
+  }
+
+  // Unlinks the head node, or returns nullptr if the container is empty.
+  // The node stays valid until it is retired and the guard is released.
+  StackNode<T> *unlink_head() {
+    StackNode<T> *node = m_head.load();
+    while (node != nullptr && !m_head.compare_exchange_weak(node, node->next)) {
+    }
+    if (node != nullptr) {
+      m_size--;
+    }
+    return node;
+  }
+
+public:
+  // Constructs an empty container
+  ConcurrentList() : m_head{nullptr}, m_size{0}, m_epoch{0} {}
+
+  // Destructor, must not race with any other operation
+  ~ConcurrentList() {
+    StackNode<T> *node = m_head.load();
+    while (node != nullptr) {
+      StackNode<T> *next = node->next;
+      delete node;
+      node = next;
+    }
+    for (size_t i = 0; i < SLOTS; i++) {
+      for (size_t list = 0; list < 3; list++) {
+        free_retired(m_slots[i].retired[list]);
+      }
+    }
+  }
+
+  ConcurrentList(const ConcurrentList<T> &) = delete;
+  ConcurrentList<T> &operator=(const ConcurrentList<T> &) = delete;
+
+  // Returns a copy of the head element
+  T head() {
+    Guard guard(*this);
+    StackNode<T> *node = m_head.load();
+    if (node == nullptr) {
+      throw std::out_of_range("List is empty");
+    }
+    return node->element;
+  }
+
+  // Checks whether the container is empty
+  bool empty() const { return m_head.load() == nullptr; }
+
+  // Returns the number of elements, only exact when no update is in flight
+  size_t size() const { return m_size.load(); }
+
+  // Inserts an element to the head
+  void push_head(const T &element) {
+    StackNode<T> *node = new StackNode<T>(element);
+    m_size++; // count before publishing so a racing pop never takes it below zero
+    node->next = m_head.load();
+    while (!m_head.compare_exchange_weak(node->next, node)) {
+    }
+  }
+
+  // Removes the head element into out, returns false if the container was empty
+  bool try_pop_head(T &out) {
+    Guard guard(*this);
+    StackNode<T> *node = unlink_head();
+    if (node == nullptr) {
+      return false;
+    }
+    // copy rather than move: contains() may still be reading the element
+    out = node->element;
+    retire(guard, node);
+    return true;
+  }
+
+  // Removes the head element and returns its value
+  T pop_head() {
+    Guard guard(*this);
+    StackNode<T> *node = unlink_head();
+    if (node == nullptr) {
+      throw std::out_of_range("List is empty");
+    }
+    T value = node->element;
+    retire(guard, node);
+    return value;
+  }
+
+  // Checks whether the container contains the specified element. Safe during
+  // concurrent updates; sees the chain as it was when the walk reached each node.
+  bool contains(const T &element) {
+    Guard guard(*this);
+    for (StackNode<T> *node = m_head.load(); node != nullptr; node = node->next) {
+      if (node->element == element) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+#endif
@@ -2,9 +2,16 @@
 #include <iostream>
 using namespace std;
 
+// The name behind a Food's shared pointer, empty for a moved-from Food
+static const string& text_of(const shared_ptr<const string>& name)
+{
+    static const string EMPTY;
+    return name ? *name : EMPTY;
+}
+
 Food Food:: operator+(const Food& rhs) const
 {
-    return Food(m_name + " " + rhs.m_name, m_calories+rhs.m_calories);
+    return Food(text_of(m_name) + " " + text_of(rhs.m_name), m_calories+rhs.m_calories);
 }
 
 
@@ -15,5 +22,5 @@ bool Food:: operator<(const Food& rhs) const
 
 bool Food:: operator==(const Food& rhs) const
 {
-    return m_name == rhs.m_name && m_calories == rhs.m_calories;
+    return text_of(m_name) == text_of(rhs.m_name) && m_calories == rhs.m_calories;
 }
@@ -1,15 +1,21 @@
 #pragma once
+#include <memory>
 #include <string>
+#include <utility>
 
 class Food {
 private:
-    std::string m_name;
+    std::shared_ptr<const std::string> m_name; // shared by copies and by Combo leaves, null once moved from
     float m_calories;
 
 public:
-    Food(std::string name, float calories) : m_name{ name }, m_calories{ calories } {}
+    Food(std::string name, float calories)
+        : m_name{ std::make_shared<const std::string>(std::move(name)) }, m_calories{ calories } {}
 
-    std::string name() const { return m_name; }
+    std::string name() const { return m_name ? *m_name : std::string(); }
+
+    // The name without copying it, shared with every copy of this Food
+    const std::shared_ptr<const std::string>& shared_name() const { return m_name; }
 
     float calories() const { return m_calories; }
 
@@ -0,0 +1,174 @@
+#include "foodtable.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FOOD_TABLE_SSE2
+#endif
+
+uint32_t FoodTable::intern(const std::string& name)
+{
+    auto found = m_name_lookup.find(name);
+    if (found != m_name_lookup.end()) {
+        return found->second;
+    }
+    uint32_t id = static_cast<uint32_t>(m_names.size());
+    m_names.push_back(name);
+    m_name_lookup.emplace(name, id);
+    return id;
+}
+
+void FoodTable::add(const std::string& name, float calories)
+{
+    m_name_ids.push_back(intern(name));
+    m_calories.push_back(calories);
+}
+
+std::vector<Food> FoodTable::to_foods() const
+{
+    std::vector<Food> foods;
+    foods.reserve(size());
+    for (size_t i = 0; i < size(); i++) {
+        foods.push_back(at(i));
+    }
+    return foods;
+}
+
+float FoodTable::max_calories() const
+{
+    if (empty()) {
+        throw std::out_of_range("FoodTable is empty");
+    }
+    const float* data = m_calories.data();
+    size_t n = m_calories.size();
+    size_t i = 0;
+    float result = data[0];
+#ifdef FOOD_TABLE_SSE2
+    if (n >= 4) {
+        __m128 best = _mm_loadu_ps(data);
+        for (i = 4; i + 4 <= n; i += 4) {
+            best = _mm_max_ps(best, _mm_loadu_ps(data + i));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, best);
+        result = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    }
+#endif
+    for (; i < n; i++) {
+        result = std::max(result, data[i]);
+    }
+    return result;
+}
+
+float FoodTable::min_calories() const
+{
+    if (empty()) {
+        throw std::out_of_range("FoodTable is empty");
+    }
+    const float* data = m_calories.data();
+    size_t n = m_calories.size();
+    size_t i = 0;
+    float result = data[0];
+#ifdef FOOD_TABLE_SSE2
+    if (n >= 4) {
+        __m128 best = _mm_loadu_ps(data);
+        for (i = 4; i + 4 <= n; i += 4) {
+            best = _mm_min_ps(best, _mm_loadu_ps(data + i));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, best);
+        result = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+    }
+#endif
+    for (; i < n; i++) {
+        result = std::min(result, data[i]);
+    }
+    return result;
+}
+
+// Sums in double so long tables don't lose precision
+double FoodTable::sum_calories() const
+{
+    const float* data = m_calories.data();
+    size_t n = m_calories.size();
+    size_t i = 0;
+    double result = 0;
+#ifdef FOOD_TABLE_SSE2
+    __m128d low = _mm_setzero_pd();
+    __m128d high = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m128 values = _mm_loadu_ps(data + i);
+        low = _mm_add_pd(low, _mm_cvtps_pd(values));
+        high = _mm_add_pd(high, _mm_cvtps_pd(_mm_movehl_ps(values, values)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(low, high));
+    result = lanes[0] + lanes[1];
+#endif
+    for (; i < n; i++) {
+        result += data[i];
+    }
+    return result;
+}
+
+std::vector<size_t> FoodTable::top_k(size_t k) const
+{
+    k = std::min(k, size());
+    if (k == 0) {
+        return std::vector<size_t>();
+    }
+    // min-heap of the best k seen so far; on equal calories the later item ranks lower
+    auto ranks_lower = [this](size_t a, size_t b) {
+        return m_calories[a] < m_calories[b] || (m_calories[a] == m_calories[b] && a > b);
+    };
+    auto worst_on_top = [&ranks_lower](size_t a, size_t b) { return ranks_lower(b, a); };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(worst_on_top)> best(worst_on_top);
+    for (size_t i = 0; i < size(); i++) {
+        if (best.size() < k) {
+            best.push(i);
+        }
+        else if (m_calories[i] > m_calories[best.top()]) {
+            best.pop();
+            best.push(i);
+        }
+    }
+    std::vector<size_t> result(k);
+    for (size_t i = k; i-- > 0;) {
+        result[i] = best.top();
+        best.pop();
+    }
+    return result;
+}
+
+std::vector<size_t> FoodTable::filter_calories(float lo, float hi) const
+{
+    std::vector<size_t> result;
+    const float* data = m_calories.data();
+    size_t n = m_calories.size();
+    size_t i = 0;
+#ifdef FOOD_TABLE_SSE2
+    const __m128 low = _mm_set1_ps(lo);
+    const __m128 high = _mm_set1_ps(hi);
+    for (; i + 4 <= n; i += 4) {
+        __m128 values = _mm_loadu_ps(data + i);
+        int mask = _mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(values, low), _mm_cmple_ps(values, high)));
+        while (mask != 0) {
+            int lane = 0;
+            while ((mask & (1 << lane)) == 0) {
+                lane++;
+            }
+            result.push_back(i + lane);
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (data[i] >= lo && data[i] <= hi) {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
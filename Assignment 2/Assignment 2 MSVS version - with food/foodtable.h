@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "food.h"
+
+// Catalog of Food stored as a struct of arrays: calories sit in one
+// contiguous float array, names are interned once in a string pool and
+// referenced by id. Calorie queries only touch the float array.
+class FoodTable {
+private:
+    std::vector<float> m_calories;
+    std::vector<uint32_t> m_name_ids;
+    std::vector<std::string> m_names;                       // pool of distinct names
+    std::unordered_map<std::string, uint32_t> m_name_lookup; // name -> id in m_names
+
+    uint32_t intern(const std::string& name);
+
+public:
+    FoodTable() {}
+
+    // Builds a table from a range of Food
+    template <typename It>
+    FoodTable(It first, It last) {
+        for (; first != last; ++first) {
+            add(*first);
+        }
+    }
+
+    // Appends an item
+    void add(const std::string& name, float calories);
+    void add(const Food& food) { add(food.name(), food.calories()); }
+
+    size_t size() const { return m_calories.size(); }
+    bool empty() const { return m_calories.empty(); }
+
+    // Number of distinct names in the pool
+    size_t distinct_names() const { return m_names.size(); }
+
+    float calories(size_t index) const { return m_calories[index]; }
+    const std::string& name(size_t index) const { return m_names[m_name_ids[index]]; }
+
+    // Converts one item, or the whole table, back to Food
+    Food at(size_t index) const { return Food(name(index), m_calories[index]); }
+    std::vector<Food> to_foods() const;
+
+    // Calorie queries, vectorised where SSE2 is available. max/min throw on an empty table.
+    float max_calories() const;
+    float min_calories() const;
+    double sum_calories() const;
+
+    // Indices of the k items with the most calories, highest first (earlier items win ties)
+    std::vector<size_t> top_k(size_t k) const;
+
+    // Indices of the items with lo <= calories <= hi, in table order
+    std::vector<size_t> filter_calories(float lo, float hi) const;
+};
@@ -0,0 +1,167 @@
+#ifndef INTRUSIVE_LIST_H
+#define INTRUSIVE_LIST_H
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// Link an element embeds to be kept in an IntrusiveList<T>:
+//   struct Reading : ListHook<Reading> { ... };
+// Copying an element never copies its link, so a copy starts out unlinked.
+template <typename T> struct ListHook {
+  T *next;
+
+  ListHook() : next{nullptr} {}
+  ListHook(const ListHook &) : next{nullptr} {}
+  ListHook &operator=(const ListHook &) { return *this; }
+};
+
+// List<T> over elements that live somewhere else (an array, a vector, the
+// stack) and carry their own next pointer. The list never allocates, copies
+// or destroys an element: push_head and pop_head only relink the objects they
+// are given. An element can be in at most one IntrusiveList at a time and
+// must outlive its time in the list.
+template <typename T> class IntrusiveList {
+private:
+  size_t m_size;
+  T *m_head;
+
+  static T *&next_of(T &element) { return static_cast<ListHook<T> &>(element).next; }
+  static T *next_of(const T &element) { return static_cast<const ListHook<T> &>(element).next; }
+
+  void swap(IntrusiveList<T> &other) noexcept {
+    std::swap(m_head, other.m_head);
+    std::swap(m_size, other.m_size);
+  }
+
+  // Helper for to_string(), finds to_string(const T&) next to T
+  static std::string element_to_string(const T &element) {
+    using std::to_string;
+    return to_string(element);
+  }
+
+public:
+  // Constructs an empty container
+  IntrusiveList() : m_size{0}, m_head{nullptr} {}
+
+  // Unlinks every element, nothing is freed
+  ~IntrusiveList() { clear(); }
+
+  // An element has a single link, so a list can't be copied
+  IntrusiveList(const IntrusiveList<T> &) = delete;
+  IntrusiveList<T> &operator=(const IntrusiveList<T> &) = delete;
+
+  // Move constructor, takes over other's chain
+  IntrusiveList(IntrusiveList<T> &&other) noexcept : m_size{0}, m_head{nullptr} {
+    swap(other);
+  }
+
+  // Move assignment, unlinks this list's old elements
+  IntrusiveList<T> &operator=(IntrusiveList<T> &&other) noexcept {
+    if (this == &other) return *this;
+    IntrusiveList<T> temp(std::move(other));
+    temp.swap(*this);
+    return *this;
+  }
+
+  // Returns the head element
+  T& head() {
+    if (m_size <= 0) {
+      throw std::out_of_range("List is empty");
+    }
+    return *m_head;
+  }
+
+  // Checks whether the container is empty
+  bool empty() const { return m_size == 0; }
+
+  // Returns the number of elements
+  size_t size() const { return m_size; }
+
+  // Links element in at the head; it must not already be in a list
+  void push_head(T& element) {
+    next_of(element) = m_head;
+    m_head = &element;
+    m_size++;
+  }
+
+  // Unlinks the head element and returns it
+  T& pop_head() {
+    if (m_size <= 0) {
+      throw std::out_of_range("List is empty");
+    }
+    T *element = m_head;
+    m_head = next_of(*element);
+    next_of(*element) = nullptr;
+    m_size--;
+    return *element;
+  }
+
+  // Unlinks every element
+  void clear() {
+    while (m_head != nullptr) {
+      T *element = m_head;
+      m_head = next_of(*element);
+      next_of(*element) = nullptr;
+    }
+    m_size = 0;
+  }
+
+  // Checks whether the container contains an element equal to element
+  bool contains(const T& element) const {
+    for (const T *current = m_head; current != nullptr; current = next_of(*current)) {
+      if (*current == element) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Unlinks the maximum element (nearest to head for duplicates) and returns it
+  T& extract_max() {
+    if (empty()) {
+      throw std::out_of_range("List is empty");
+    }
+    T **link = &m_head;
+    T **maximumLink = link;
+    while (*link != nullptr) {
+      if (**link > **maximumLink) {
+        maximumLink = link;
+      }
+      link = &next_of(**link);
+    }
+    T *max = *maximumLink;
+    *maximumLink = next_of(*max);
+    next_of(*max) = nullptr;
+    m_size--;
+    return *max;
+  }
+
+  // Reverse the container
+  void reverse() {
+    T *prev = nullptr;
+    T *curr = m_head;
+    while (curr != nullptr) {
+      T *next = next_of(*curr);
+      next_of(*curr) = prev;
+      prev = curr;
+      curr = next;
+    }
+    m_head = prev;
+  }
+
+  // Returns a std::string equivalent of the container
+  std::string to_string() const {
+    std::string answer = "{";
+    for (const T *current = m_head; current != nullptr; current = next_of(*current)) {
+      answer += element_to_string(*current);
+      if (next_of(*current) != nullptr) {
+        answer += ", ";
+      }
+    }
+    answer += "}";
+    return answer;
+  }
+};
+
+#endif
@@ -2,28 +2,266 @@
 #ifndef LINKED_LIST_H
 #define LINKED_LIST_H
 
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
+#include <iterator>
+#include <new>
+#include <ostream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include "membershipindex.hpp"
 
 template <typename T> struct Node {
   T element;
   Node<T> *next;
 
-  Node(T element) : element{element}, next{nullptr} {}              //constructor for first
-  Node(T element, Node<T> *next) : element{element}, next{next} {}  //constructor for linked (overload)
+  Node(const T &element) : element{element}, next{nullptr} {}              //constructor for first
+  Node(const T &element, Node<T> *next) : element{element}, next{next} {}  //constructor for linked (overload)
+  Node(T &&element, Node<T> *next) : element{std::move(element)}, next{next} {}  //moves the element in
+
+  // Constructs the element in place from args
+  template <typename... Args>
+  Node(std::piecewise_construct_t, Node<T> *next, Args &&...args)
+      : element(std::forward<Args>(args)...), next{next} {}
+};
+
+// Per-list node allocator. Nodes are carved out of chunks of NODES_PER_CHUNK
+// slots, and released nodes go onto an intrusive free list so the next
+// push_head reuses them instead of calling new/delete every time.
+template <typename T> class NodePool {
+private:
+  static const size_t NODES_PER_CHUNK = 64;
+
+  // A released slot reuses its storage to point at the next free slot
+  struct FreeSlot {
+    FreeSlot *next;
+  };
+
+  struct Chunk {
+    Chunk *next;
+    alignas(Node<T>) unsigned char slots[NODES_PER_CHUNK][sizeof(Node<T>)];
+  };
+
+  Chunk *m_chunks;      // newest chunk first
+  Chunk *m_oldest;      // last chunk of m_chunks, so absorb() can link behind it
+  size_t m_bump;        // number of slots handed out from the newest chunk
+  FreeSlot *m_free;     // released slots, most recent first
+  FreeSlot *m_free_tail; // last slot of m_free, so absorb() can append to it
+
+  void *allocate() {
+    if (m_free != nullptr) {
+      FreeSlot *slot = m_free;
+      m_free = slot->next;
+      if (m_free == nullptr) m_free_tail = nullptr;
+      return slot;
+    }
+    if (m_chunks == nullptr || m_bump == NODES_PER_CHUNK) {
+      Chunk *chunk = new Chunk;
+      chunk->next = m_chunks;
+      m_chunks = chunk;
+      if (m_oldest == nullptr) m_oldest = chunk;
+      m_bump = 0;
+    }
+    return m_chunks->slots[m_bump++];
+  }
+
+public:
+  NodePool() : m_chunks{nullptr}, m_oldest{nullptr}, m_bump{0}, m_free{nullptr}, m_free_tail{nullptr} {}
+
+  // Returns every chunk at once; live nodes must already be destroyed
+  ~NodePool() {
+    while (m_chunks != nullptr) {
+      Chunk *chunk = m_chunks;
+      m_chunks = m_chunks->next;
+      delete chunk;
+    }
+  }
+
+  NodePool(const NodePool &) = delete;
+  NodePool &operator=(const NodePool &) = delete;
+
+  // Constructs a node in a free slot
+  template <typename... Args> Node<T> *create(Args &&...args) {
+    void *slot = allocate();
+    try {
+      return new (slot) Node<T>(std::forward<Args>(args)...);
+    } catch (...) {
+      release(slot);
+      throw;
+    }
+  }
+
+  // Destroys the node and puts its slot back on the free list
+  void destroy(Node<T> *node) {
+    node->~Node<T>();
+    release(node);
+  }
+
+  void swap(NodePool &other) noexcept {
+    std::swap(m_chunks, other.m_chunks);
+    std::swap(m_oldest, other.m_oldest);
+    std::swap(m_bump, other.m_bump);
+    std::swap(m_free, other.m_free);
+    std::swap(m_free_tail, other.m_free_tail);
+  }
+
+  // Takes over every chunk of other, live nodes included, and leaves other
+  // empty. O(1): at most one chunk's worth of unused slots is moved to the
+  // free list, the chunk chains and free lists are linked end to end.
+  void absorb(NodePool &other) {
+    if (other.m_chunks == nullptr) return;
+    if (m_chunks == nullptr) {
+      swap(other);
+      return;
+    }
+    // other's newest chunk stops being the one bump-allocated from
+    while (other.m_bump < NODES_PER_CHUNK) {
+      other.release(other.m_chunks->slots[other.m_bump++]);
+    }
+    m_oldest->next = other.m_chunks;
+    m_oldest = other.m_oldest;
+    if (other.m_free != nullptr) {
+      if (m_free == nullptr) {
+        m_free = other.m_free;
+      }
+      else {
+        m_free_tail->next = other.m_free;
+      }
+      m_free_tail = other.m_free_tail;
+    }
+    other.m_chunks = nullptr;
+    other.m_oldest = nullptr;
+    other.m_bump = 0;
+    other.m_free = nullptr;
+    other.m_free_tail = nullptr;
+  }
+
+private:
+  void release(void *slot) {
+    FreeSlot *freeSlot = new (slot) FreeSlot{m_free};
+    if (m_free == nullptr) m_free_tail = freeSlot;
+    m_free = freeSlot;
+  }
 };
 
-template <typename T> class List {
+// Index is an optional membership index (see membershipindex.hpp) that
+// push_head/pop_head/extract_max keep up to date so contains() can answer
+// without walking. The default is empty and held as a base class, so a
+// plain List<T> is no bigger and no slower than before.
+template <typename T, typename Index = NoMembershipIndex<T>> class List : private Index {
 private:
   size_t m_size;
   Node<T> *m_head;
+  Node<T> *m_tail;    // last node, nullptr when empty
+  NodePool<T> m_pool;
+
+  Index& index() { return *this; }
+  const Index& index() const { return *this; }
 
   // Feel free to add helper functions here, if necessary
  
   // Swap function (helper)
-  void swap(List<T>& other) {
+  void swap(List& other) noexcept {
       std::swap(m_head, other.m_head);
+      std::swap(m_tail, other.m_tail);
       std::swap(m_size, other.m_size);
+      m_pool.swap(other.m_pool);
+      std::swap(index(), other.index());
+  }
+
+  // Adds a new node's element to the index. If that throws, the node never
+  // reaches the list, so it is destroyed and its slot freed here.
+  void index_new_node(Node<T>* node) {
+      try {
+          index().add(node->element);
+      }
+      catch (...) {
+          m_pool.destroy(node);
+          throw;
+      }
+  }
+
+  // Links a new node in at the head
+  void link_head(Node<T>* node) {
+      index_new_node(node);
+      if (m_tail == nullptr) m_tail = node;
+      m_head = node;
+      m_size++;
+  }
+
+  // Links a new node in at the tail
+  void link_tail(Node<T>* node) {
+      index_new_node(node);
+      if (m_tail == nullptr) {
+          m_head = node;
+      }
+      else {
+          m_tail->next = node;
+      }
+      m_tail = node;
+      m_size++;
+  }
+
+  // Detaches the head node; removing it from the index and destroying it is
+  // left to the caller
+  Node<T>* unlink_head() {
+      Node<T>* node = m_head;
+      m_head = m_head->next;
+      if (m_head == nullptr) m_tail = nullptr;
+      m_size--;
+      return node;
+  }
+
+  // Takes other's nodes, pool chunks and index entries; other is left empty.
+  // The caller links other's chain in first.
+  void absorb(List& other) {
+      m_size += other.m_size;
+      m_pool.absorb(other.m_pool);
+      index().absorb(other.index());
+      other.m_head = nullptr;
+      other.m_tail = nullptr;
+      other.m_size = 0;
+  }
+
+  // Cuts the chain after count nodes and returns the rest
+  static Node<T>* split(Node<T>* node, size_t count) {
+      for (size_t i = 1; node != nullptr && i < count; i++) {
+          node = node->next;
+      }
+      if (node == nullptr) return nullptr;
+      Node<T>* rest = node->next;
+      node->next = nullptr;
+      return rest;
+  }
+
+  // Merges two sorted chains onto *link, taking from left on ties (stable).
+  // Returns the link of the last merged node and sets last to that node.
+  template <typename Compare>
+  static Node<T>** merge(Node<T>* left, Node<T>* right, Node<T>** link, Node<T>*& last, Compare& comp) {
+      while (left != nullptr && right != nullptr) {
+          if (comp(right->element, left->element)) {
+              *link = right;
+              right = right->next;
+          }
+          else {
+              *link = left;
+              left = left->next;
+          }
+          last = *link;
+          link = &(*link)->next;
+      }
+      *link = left != nullptr ? left : right;
+      while (*link != nullptr) {
+          last = *link;
+          link = &(*link)->next;
+      }
+      return link;
   }
 
   // Helper for to_string()
@@ -36,12 +274,130 @@ private:
       return "\"" + element + "\"";
   }
 
+  // Room for any integer or double to_chars produces: a double in fixed
+  // notation is at most 309 integer digits, a sign, a point and 6 decimals.
+  // A long double can need more; format_number then reports failure.
+  static const size_t MAX_ELEMENT_CHARS = 320;
+
+  // Formats an arithmetic element into buffer[0, MAX_ELEMENT_CHARS) the same
+  // way std::to_string does. Returns the end of the text, or nullptr if it
+  // doesn't fit.
+  template <typename U>
+  static char* format_number(char* buffer, const U& element) {
+      std::to_chars_result result;
+      if constexpr (std::is_floating_point<U>::value) {
+          result = std::to_chars(buffer, buffer + MAX_ELEMENT_CHARS, element, std::chars_format::fixed, 6);
+      }
+      else if constexpr (std::is_same<U, bool>::value) {
+          result = std::to_chars(buffer, buffer + MAX_ELEMENT_CHARS, static_cast<int>(element));
+      }
+      else {
+          result = std::to_chars(buffer, buffer + MAX_ELEMENT_CHARS, element);
+      }
+      return result.ec == std::errc() ? result.ptr : nullptr;
+  }
+
+  // Length of an element in to_string()
+  template <typename U>
+  size_t element_length(const U& element) const {
+      if constexpr (std::is_arithmetic<U>::value) {
+          char buffer[MAX_ELEMENT_CHARS];
+          char* end = format_number(buffer, element);
+          return end != nullptr ? end - buffer : element_to_string(element).size();
+      }
+      else {
+          return element_to_string(element).size();
+      }
+  }
+  size_t element_length(const std::string& element) const {
+      return element.size() + 2;
+  }
+
+  // Writes an element at out, returns the end of what was written
+  template <typename U>
+  char* write_element(char* out, const U& element) const {
+      if constexpr (std::is_arithmetic<U>::value) {
+          char buffer[MAX_ELEMENT_CHARS]; // out only has room for the element's exact length
+          char* end = format_number(buffer, element);
+          if (end != nullptr) {
+              std::memcpy(out, buffer, end - buffer);
+              return out + (end - buffer);
+          }
+      }
+      std::string text = element_to_string(element);
+      std::memcpy(out, text.data(), text.size());
+      return out + text.size();
+  }
+  // Streams an element the same way write_element(char*, ...) writes it
+  template <typename U>
+  void write_element(std::ostream& os, const U& element) const {
+      if constexpr (std::is_arithmetic<U>::value) {
+          char buffer[MAX_ELEMENT_CHARS];
+          char* end = format_number(buffer, element);
+          if (end != nullptr) {
+              os.write(buffer, end - buffer);
+              return;
+          }
+      }
+      os << element_to_string(element);
+  }
+  char* write_element(char* out, const std::string& element) const {
+      *out++ = '"';
+      std::memcpy(out, element.data(), element.size());
+      out += element.size();
+      *out++ = '"';
+      return out;
+  }
+
+  // Forward iterator over the nodes, Const selects const access to the elements
+  template <bool Const> class Iterator {
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef typename std::conditional<Const, const T*, T*>::type pointer;
+    typedef typename std::conditional<Const, const T&, T&>::type reference;
+
+    Iterator() : m_node{nullptr} {}
+    explicit Iterator(Node<T>* node) : m_node{node} {}
+    // mutable iterators convert to const ones
+    template <bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+    Iterator(const Iterator<OtherConst>& other) : m_node{other.node()} {}
+
+    reference operator*() const { return m_node->element; }
+    pointer operator->() const { return &m_node->element; }
+
+    Iterator& operator++() {
+      m_node = m_node->next;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator old = *this;
+      m_node = m_node->next;
+      return old;
+    }
+
+    bool operator==(const Iterator& other) const { return m_node == other.m_node; }
+    bool operator!=(const Iterator& other) const { return m_node != other.m_node; }
+
+    Node<T>* node() const { return m_node; }
+
+  private:
+    Node<T>* m_node;
+  };
+
 public:
+  typedef Iterator<true> const_iterator;
+  // Writing through an iterator would bypass the membership index, so
+  // indexed lists only hand out const iterators
+  typedef typename std::conditional<std::is_same<Index, NoMembershipIndex<T>>::value,
+                                    Iterator<false>, Iterator<true>>::type iterator;
+
   // Constructs an empty container
-  List() : m_size{0}, m_head{nullptr} {}
+  List() : m_size{0}, m_head{nullptr}, m_tail{nullptr} {}
 
   // Constructs the container with the contents of the initializer list
-  List(std::initializer_list<T> init_list) : m_size{0}, m_head{nullptr} {
+  List(std::initializer_list<T> init_list) : m_size{0}, m_head{nullptr}, m_tail{nullptr} {
     auto it = init_list.end();
     while (--it != init_list.begin()) {
       push_head(*it);
@@ -58,54 +414,81 @@ public:
   ~List() {
     // TODO: (Optional) Implement this method
     //removeHead() but dont need m_size, terminates when current==nullptr
-      Node<T>* current = m_head;
-      while (current != nullptr) { 
-          Node<T>* temp = current;
-          current = current->next;
-          delete temp;
+    //the pool frees the chunks, so only elements with a destructor need a walk
+      if (!std::is_trivially_destructible<T>::value) {
+          Node<T>* current = m_head;
+          while (current != nullptr) {
+              Node<T>* temp = current;
+              current = current->next;
+              temp->~Node<T>();
+          }
       }
       m_head = nullptr;
+      m_tail = nullptr;
       m_size = 0;
   }
 
   // Copy constructor (creates new object as a copy of `other` object) 
-  List(const List<T> &other) {
+  List(const List &other) : Index(other), m_size{0}, m_head{nullptr}, m_tail{nullptr} {
     // TODO: (Optional) Implement this method
-      m_head = nullptr;
-      m_size = 0;
       Node<T>* currentOthernode = other.m_head;
-      Node<T>* tail = nullptr; //track last node of new list
 
       //copy every node from other by iterating through its list
       while (currentOthernode != nullptr) {
-          Node<T>* newNode = new Node<T>(currentOthernode->element);
+          Node<T>* newNode = m_pool.create(currentOthernode->element);
           //if first node, set it to head
           if (empty()) {
               m_head = newNode;
-              tail = newNode;
+              m_tail = newNode;
           }
           else { //append at tail
-              tail->next = newNode;
-              tail = newNode;
+              m_tail->next = newNode;
+              m_tail = newNode;
           }
           m_size++;
           currentOthernode = currentOthernode->next;
       }
   }
 
+  // Move constructor, takes over other's nodes, pool and index in O(1)
+  // without allocating
+  List(List &&other) noexcept
+      : Index(std::move(other.index())), m_size{other.m_size}, m_head{other.m_head}, m_tail{other.m_tail} {
+      m_pool.swap(other.m_pool);
+      other.m_head = nullptr;
+      other.m_tail = nullptr;
+      other.m_size = 0;
+  }
+
   // Copy assignment
-  List<T> &operator=(const List<T> &other) {
+  List &operator=(const List &other) {
     // TODO: (Optional) Implement this method
       if (this == &other) return *this; //check for self-assigning
 
       //just use the copy constructor, and swap
-      List<T> temp(other);
+      List temp(other);
       temp.swap(*this);
 
       //when temp goes out of scope, temp is destructored; cleans up old data too
       return *this; 
   }
 
+  // Move assignment
+  List &operator=(List &&other) noexcept {
+      if (this == &other) return *this;
+      List temp(std::move(other));
+      temp.swap(*this); //old data is released with temp
+      return *this;
+  }
+
+  // Iterators from head to the end of the chain
+  iterator begin() { return iterator(m_head); }
+  iterator end() { return iterator(); }
+  const_iterator begin() const { return const_iterator(m_head); }
+  const_iterator end() const { return const_iterator(); }
+  const_iterator cbegin() const { return const_iterator(m_head); }
+  const_iterator cend() const { return const_iterator(); }
+
   // Returns the contents of the head node
   const T& head() {
     if (m_size <= 0) {
@@ -114,6 +497,14 @@ public:
     return m_head->element;
   }
 
+  // Returns the contents of the tail node
+  const T& tail() {
+    if (m_size <= 0) {
+      throw std::out_of_range("List is empty");
+    }
+    return m_tail->element;
+  }
+
   // Checks whether the container is empty
   bool empty() const { return m_size == 0; }
 
@@ -122,9 +513,51 @@ public:
 
   // Inserts an element to the head
   void push_head(const T& element) {
-    Node<T> *node = new Node<T>{element, m_head};
-    m_head = node;
-    m_size++;
+    link_head(m_pool.create(element, m_head));
+  }
+
+  // Inserts an element to the head, moving it in
+  void push_head(T&& element) {
+    link_head(m_pool.create(std::move(element), m_head));
+  }
+
+  // Constructs an element in place at the head
+  template <typename... Args> void emplace_head(Args&&... args) {
+    link_head(m_pool.create(std::piecewise_construct, m_head, std::forward<Args>(args)...));
+  }
+
+  // Inserts an element to the tail in O(1)
+  void push_tail(const T& element) {
+    link_tail(m_pool.create(element, nullptr));
+  }
+
+  // Inserts an element to the tail, moving it in
+  void push_tail(T&& element) {
+    link_tail(m_pool.create(std::move(element), nullptr));
+  }
+
+  // Moves every element of other in front of this list's head in O(1) and
+  // leaves other empty. The nodes stay where they are: this list's pool
+  // takes over other's chunks. An index, if any, is merged too.
+  void splice_front(List&& other) {
+      if (this == &other || other.empty()) return;
+      other.m_tail->next = m_head;
+      if (m_tail == nullptr) m_tail = other.m_tail;
+      m_head = other.m_head;
+      absorb(other);
+  }
+
+  // Moves every element of other behind this list's tail in O(1), like splice_front
+  void concat(List&& other) {
+      if (this == &other || other.empty()) return;
+      if (m_tail == nullptr) {
+          m_head = other.m_head;
+      }
+      else {
+          m_tail->next = other.m_head;
+      }
+      m_tail = other.m_tail;
+      absorb(other);
   }
 
   // Removes the head element
@@ -132,23 +565,21 @@ public:
     if (m_size <= 0) {
       throw std::out_of_range("List is empty");
     }
-    Node<T> *node = m_head;
-    m_head = m_head->next;
-    delete node;
-    m_size--;
+    Node<T> *node = unlink_head();
+    index().remove(node->element);
+    m_pool.destroy(node);
   }
 
   // Checks whether the container contains the specified element
   bool contains(const T& element) const {
     // TODO: Implement this method
-      Node<T>* currentNode = m_head;
-      while (currentNode != nullptr) {
-          if (currentNode->element == element) {
-              return true;
-          }
-          currentNode = currentNode->next;
+      if (!index().may_contain(element)) {
+          return false;
       }
-    return false;
+      if (Index::exact) {
+          return true;
+      }
+      return std::find(begin(), end(), element) != end();
   }
 
   // Extracts the maximum element from the container
@@ -179,7 +610,9 @@ public:
       }
       else {
           beforeMaxNode->next = maximumNode->next;
-          delete maximumNode;
+          if (maximumNode == m_tail) m_tail = beforeMaxNode;
+          index().remove(maximumNode->element);
+          m_pool.destroy(maximumNode);
           m_size--;
       }
       return max;
@@ -196,6 +629,7 @@ public:
       Node<T>* prev = nullptr;
       Node<T>* curr = m_head;
       Node<T>* next = nullptr;
+      m_tail = m_head; //old head ends up last
 
       while (curr != nullptr) {
           next = curr->next;
@@ -206,23 +640,86 @@ public:
       m_head = prev;
   }
 
-  // Returns a std::string equivalent of the container
-  std::string to_string() const {
-    // TODO: Implement this method
+  // Stable merge sort by relinking the existing nodes, O(n log n) and no allocation.
+  // Bottom-up, so there is no recursion to run out of stack on long lists.
+  template <typename Compare = std::less<T>>
+  void sort(Compare comp = Compare()) {
+      for (size_t width = 1; width < m_size; width *= 2) {
+          Node<T>* rest = m_head;
+          Node<T>** link = &m_head;
+          while (rest != nullptr) {
+              Node<T>* left = rest;
+              Node<T>* right = split(left, width);
+              rest = split(right, width);
+              link = merge(left, right, link, m_tail, comp);
+          }
+      }
+  }
+
+  // Moves every element into out from largest to smallest and empties the container.
+  // Gives the same order as calling extract_max until empty, in O(n log n).
+  template <typename OutputIt>
+  OutputIt drain_sorted_desc(OutputIt out) {
+      sort([](const T& a, const T& b) { return b < a; });
+      while (!empty()) {
+          Node<T>* node = unlink_head();
+          index().remove(node->element); // while the element still has its value
+          try {
+              *out++ = std::move(node->element);
+          }
+          catch (...) {
+              m_pool.destroy(node);
+              throw;
+          }
+          m_pool.destroy(node);
+      }
+      return out;
+  }
+
+  // Exact number of characters to_string() produces
+  size_t string_length() const {
       if (empty()) {
-          return "{}";
+          return 2;
       }
-      Node<T>* currentNode = m_head;
-      std::string answer = "{";
+      size_t length = 2 + 2 * (m_size - 1); // braces and ", " separators
+      for (Node<T>* currentNode = m_head; currentNode != nullptr; currentNode = currentNode->next) {
+          length += element_length(currentNode->element);
+      }
+      return length;
+  }
 
-      while (currentNode != nullptr) {
-          answer += element_to_string(currentNode->element);   //use overloaded function
-          if (currentNode->next != nullptr) {				
-              answer += ", ";								
+  // Writes to_string() into a buffer of at least string_length() chars,
+  // returns the end of what was written. No allocation for numbers.
+  char* write_to(char* out) const {
+      *out++ = '{';
+      for (Node<T>* currentNode = m_head; currentNode != nullptr; currentNode = currentNode->next) {
+          out = write_element(out, currentNode->element);
+          if (currentNode->next != nullptr) {
+              *out++ = ',';
+              *out++ = ' ';
           }
-          currentNode = currentNode->next;
       }
-      answer += "}";
+      *out++ = '}';
+      return out;
+  }
+
+  // Streams to_string() into os, one element at a time
+  std::ostream& write_to(std::ostream& os) const {
+      os.put('{');
+      for (Node<T>* currentNode = m_head; currentNode != nullptr; currentNode = currentNode->next) {
+          write_element(os, currentNode->element);
+          if (currentNode->next != nullptr) {
+              os.write(", ", 2);
+          }
+      }
+      os.put('}');
+      return os;
+  }
+
+  // Returns a std::string equivalent of the container, sized up front so it allocates once
+  std::string to_string() const {
+      std::string answer(string_length(), '\0');
+      write_to(&answer[0]);
       return answer;
   }
 
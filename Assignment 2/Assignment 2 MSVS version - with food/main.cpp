@@ -7,8 +7,47 @@
 
 #include <iostream>
 #include "food.h"
+#include "foodtable.h"
+#include "combo.h"
+#include "mealsearch.h"
+#include "allocationcounter.h"
 #include "LinkedList.hpp"
+#include "unrolledlist.hpp"
+#include "concurrentlist.hpp"
+#include "persistentlist.hpp"
+#include "intrusivelist.hpp"
+#include "smalllist.hpp"
+#include "sortedlist.hpp"
+#include "parallellist.hpp"
 #include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cfloat>
+#include <chrono>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+void push_pop_benchmark();
+void unrolled_contains_benchmark();
+void allocation_benchmark();
+void sorted_drain_benchmark();
+void concurrent_stress_test();
+void concurrent_benchmark();
+void snapshot_benchmark();
+void to_string_benchmark();
+void membership_index_benchmark();
+void parallel_scan_benchmark();
+void food_table_benchmark();
+void combo_benchmark();
+void meal_search_benchmark();
+void intrusive_list_benchmark();
+void small_list_benchmark();
+void concat_benchmark();
+void sorted_list_benchmark();
 
 int main(int argc, const char * argv[]) {
 
@@ -38,5 +77,893 @@ int main(int argc, const char * argv[]) {
     List<int> list2(SAMPLE_INTS);
     std::cout << list2.to_string() << std::endl;
 
+    push_pop_benchmark();
+    unrolled_contains_benchmark();
+    allocation_benchmark();
+    sorted_drain_benchmark();
+    concurrent_stress_test();
+    concurrent_benchmark();
+    snapshot_benchmark();
+    to_string_benchmark();
+    membership_index_benchmark();
+    food_table_benchmark();
+    combo_benchmark();
+    meal_search_benchmark();
+    intrusive_list_benchmark();
+    small_list_benchmark();
+    concat_benchmark();
+    sorted_list_benchmark();
+    parallel_scan_benchmark(); // keep last, it needs the most memory
+
     return 0;
 }
+
+// Compares List<int> push_head/pop_head (pooled nodes) against a plain
+// new/delete node stack, which is what push_head/pop_head used to do.
+void push_pop_benchmark()
+{
+    std::cout << "push_pop_benchmark()" << std::endl;
+    const int ROUNDS = 100;
+    const int DEPTH = 10000;
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point start = Clock::now();
+    Node<int>* stack = nullptr;
+    long long checksum = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < DEPTH; i++) {
+            stack = new Node<int>{ i, stack };
+        }
+        while (stack != nullptr) {
+            Node<int>* node = stack;
+            stack = stack->next;
+            checksum += node->element;
+            delete node;
+        }
+    }
+    double newDeleteMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    List<int> list;
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int i = 0; i < DEPTH; i++) {
+            list.push_head(i);
+        }
+        while (!list.empty()) {
+            checksum -= list.head();
+            list.pop_head();
+        }
+    }
+    double pooledMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    const double ops = 2.0 * ROUNDS * DEPTH;
+    std::cout << "new/delete: " << ops / newDeleteMs / 1000 << " Mops/s" << std::endl;
+    std::cout << "pooled:     " << ops / pooledMs / 1000 << " Mops/s" << std::endl;
+    std::cout << "checksum (should be 0): " << checksum << std::endl;
+}
+
+
+// Compares contains() misses (full scans) on List<int> and UnrolledList<int>.
+// Each container is built and scanned in its own scope, so their
+// allocations don't interleave and each gets the layout it builds alone.
+void unrolled_contains_benchmark()
+{
+    std::cout << "unrolled_contains_benchmark()" << std::endl;
+    const int COUNT = 1000000;
+    const int LOOKUPS = 20;
+    typedef std::chrono::steady_clock Clock;
+
+    int found = 0;
+    double listMs;
+    {
+        List<int> list;
+        for (int i = 0; i < COUNT; i++) {
+            list.push_head(i);
+        }
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < LOOKUPS; i++) {
+            found += list.contains(-i - 1);
+        }
+        listMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    double unrolledMs;
+    {
+        UnrolledList<int> unrolled;
+        for (int i = 0; i < COUNT; i++) {
+            unrolled.push_head(i);
+        }
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < LOOKUPS; i++) {
+            found += unrolled.contains(-i - 1);
+        }
+        unrolledMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::cout << "List<int>::contains:         " << listMs / LOOKUPS << " ms per scan" << std::endl;
+    std::cout << "UnrolledList<int>::contains: " << unrolledMs / LOOKUPS << " ms per scan" << std::endl;
+    std::cout << "found (should be 0): " << found << std::endl;
+}
+
+// Counts allocations for copying vs moving strings into List<std::string>,
+// and for storing whole lists in a std::vector by copy vs by move
+void allocation_benchmark()
+{
+    std::cout << "allocation_benchmark()" << std::endl;
+    const int COUNT = 10000;
+    const int LISTS = 100;
+    const std::string NAME = "a name long enough to skip the small string buffer";
+
+    AllocationCounter allocations;
+    size_t before = allocations.count();
+    {
+        List<std::string> list;
+        for (int i = 0; i < COUNT; i++) {
+            std::string name = NAME;
+            list.push_head(name);
+        }
+    }
+    size_t copied = allocations.count() - before;
+
+    before = allocations.count();
+    {
+        List<std::string> list;
+        for (int i = 0; i < COUNT; i++) {
+            std::string name = NAME;
+            list.push_head(std::move(name));
+        }
+    }
+    size_t moved = allocations.count() - before;
+
+    before = allocations.count();
+    {
+        List<Food> list;
+        for (int i = 0; i < COUNT; i++) {
+            list.emplace_head(NAME, 1.5f);
+        }
+    }
+    size_t emplaced = allocations.count() - before;
+
+    std::cout << "push_head(const T&), " << COUNT << " strings: " << copied << " allocations" << std::endl;
+    std::cout << "push_head(T&&), " << COUNT << " strings:      " << moved << " allocations" << std::endl;
+    std::cout << "emplace_head, " << COUNT << " Food:            " << emplaced << " allocations" << std::endl;
+
+    List<int> source;
+    for (int i = 0; i < COUNT; i++) {
+        source.push_head(i);
+    }
+
+    std::vector<List<int>> lists;
+    lists.reserve(LISTS);
+    before = allocations.count();
+    for (int i = 0; i < LISTS; i++) {
+        lists.push_back(source);
+    }
+    size_t copiedLists = allocations.count() - before;
+
+    // growing the vector relocates every list by move, so the new buffer
+    // is the only allocation
+    before = allocations.count();
+    lists.reserve(4 * LISTS);
+    size_t grownLists = allocations.count() - before;
+    assert(grownLists == 1);
+
+    before = allocations.count();
+    for (int i = 0; i < LISTS; i++) {
+        List<int> temp(std::move(lists[i]));
+        lists[i] = std::move(temp);
+    }
+    size_t movedLists = allocations.count() - before;
+    assert(movedLists == 0);
+
+    std::cout << "copy " << LISTS << " lists of " << COUNT << " into a vector: " << copiedLists << " allocations" << std::endl;
+    std::cout << "grow the vector of " << LISTS << " lists:        " << grownLists << " allocations" << std::endl;
+    std::cout << "move " << LISTS << " lists of " << COUNT << " around:        " << movedLists << " allocations" << std::endl;
+}
+
+// Drains a list in descending order with repeated extract_max (O(n^2))
+// and with drain_sorted_desc (O(n log n)), then ranks some food by calories
+void sorted_drain_benchmark()
+{
+    std::cout << "sorted_drain_benchmark()" << std::endl;
+    const int COUNT = 20000;
+    typedef std::chrono::steady_clock Clock;
+
+    List<int> list;
+    for (int i = 0; i < COUNT; i++) {
+        list.push_head((i * 7919) % COUNT);
+    }
+    List<int> copy(list);
+
+    std::vector<int> byExtract;
+    Clock::time_point start = Clock::now();
+    while (!list.empty()) {
+        byExtract.push_back(list.extract_max());
+    }
+    double extractMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::vector<int> bySort;
+    start = Clock::now();
+    copy.drain_sorted_desc(std::back_inserter(bySort));
+    double sortMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::cout << "extract_max loop:  " << extractMs << " ms" << std::endl;
+    std::cout << "drain_sorted_desc: " << sortMs << " ms" << std::endl;
+    std::cout << "same order: " << (byExtract == bySort) << std::endl;
+
+    List<Food> menu;
+    menu.emplace_head("fries", 365.0f);
+    menu.emplace_head("salad", 150.0f);
+    menu.emplace_head("burger", 540.0f);
+    menu.emplace_head("cola", 150.0f);
+    std::vector<Food> ranked;
+    menu.drain_sorted_desc(std::back_inserter(ranked));
+    for (const Food& food : ranked) {
+        std::cout << food.name() << " " << food.calories() << std::endl;
+    }
+    // should print burger, fries, cola, salad
+}
+
+// Producers push disjoint ranges while consumers pop and a reader calls
+// contains(); every pushed value must be popped exactly once
+void concurrent_stress_test()
+{
+    std::cout << "concurrent_stress_test()" << std::endl;
+    const int PRODUCERS = 4;
+    const int CONSUMERS = 4;
+    const int PER_PRODUCER = 100000;
+    const int TOTAL = PRODUCERS * PER_PRODUCER;
+
+    ConcurrentList<int> list;
+    std::atomic<int> popped{ 0 };
+    std::vector<std::vector<int>> seen(CONSUMERS);
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < PRODUCERS; p++) {
+        threads.emplace_back([&list, p]() {
+            for (int i = 0; i < PER_PRODUCER; i++) {
+                list.push_head(p * PER_PRODUCER + i);
+            }
+        });
+    }
+    for (int c = 0; c < CONSUMERS; c++) {
+        threads.emplace_back([&list, &popped, &seen, c]() {
+            int value;
+            while (popped.load() < TOTAL) {
+                if (list.try_pop_head(value)) {
+                    seen[c].push_back(value);
+                    popped++;
+                }
+            }
+        });
+    }
+    threads.emplace_back([&list, &popped]() {
+        int probe = 0;
+        while (popped.load() < TOTAL) {
+            list.contains(probe);
+            probe = (probe + 7919) % TOTAL;
+        }
+    });
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<int> count(TOTAL, 0);
+    for (const std::vector<int>& values : seen) {
+        for (int value : values) {
+            count[value]++;
+        }
+    }
+    for (int value = 0; value < TOTAL; value++) {
+        assert(count[value] == 1);
+    }
+    assert(list.empty() && list.size() == 0);
+    std::cout << "passed" << std::endl;
+}
+
+// push_head/pop_head pairs per second on 1 to N threads, lock-free stack
+// against a List<int> behind a global mutex
+void concurrent_benchmark()
+{
+    std::cout << "concurrent_benchmark()" << std::endl;
+    const int OPS_PER_THREAD = 200000;
+    typedef std::chrono::steady_clock Clock;
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        ConcurrentList<int> lockFree;
+        List<int> locked;
+        std::mutex lock;
+        std::vector<std::thread> threads;
+
+        Clock::time_point start = Clock::now();
+        for (unsigned t = 0; t < threadCount; t++) {
+            threads.emplace_back([&lockFree]() {
+                int value;
+                for (int i = 0; i < OPS_PER_THREAD; i++) {
+                    lockFree.push_head(i);
+                    lockFree.try_pop_head(value);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        double lockFreeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        threads.clear();
+        start = Clock::now();
+        for (unsigned t = 0; t < threadCount; t++) {
+            threads.emplace_back([&locked, &lock]() {
+                for (int i = 0; i < OPS_PER_THREAD; i++) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    locked.push_head(i);
+                    locked.pop_head();
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        double lockedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        const double ops = 2.0 * OPS_PER_THREAD * threadCount;
+        std::cout << threadCount << " threads: lock-free " << ops / lockFreeMs / 1000
+            << " Mops/s, mutex " << ops / lockedMs / 1000 << " Mops/s" << std::endl;
+    }
+}
+
+// Takes many snapshots of a list, each followed by a push_head on the live list
+void snapshot_benchmark()
+{
+    std::cout << "snapshot_benchmark()" << std::endl;
+    const int COUNT = 10000;
+    const int SNAPSHOTS = 1000;
+    typedef std::chrono::steady_clock Clock;
+
+    List<int> list;
+    PersistentList<int> persistent;
+    for (int i = 0; i < COUNT; i++) {
+        list.push_head(i);
+        persistent.push_head(i);
+    }
+
+    AllocationCounter allocations;
+    size_t before = allocations.count();
+    Clock::time_point start = Clock::now();
+    {
+        std::vector<List<int>> snapshots;
+        for (int i = 0; i < SNAPSHOTS; i++) {
+            snapshots.push_back(list);
+            list.push_head(i);
+        }
+    }
+    double listMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    size_t listAllocations = allocations.count() - before;
+
+    before = allocations.count();
+    start = Clock::now();
+    {
+        std::vector<PersistentList<int>> snapshots;
+        for (int i = 0; i < SNAPSHOTS; i++) {
+            snapshots.push_back(persistent);
+            persistent.push_head(i);
+        }
+    }
+    double persistentMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    size_t persistentAllocations = allocations.count() - before;
+
+    std::cout << "List<int>:           " << listMs << " ms, " << listAllocations << " allocations" << std::endl;
+    std::cout << "PersistentList<int>: " << persistentMs << " ms, " << persistentAllocations << " allocations" << std::endl;
+    std::cout << "same contents: " << (list.to_string() == persistent.to_string()) << std::endl;
+}
+
+// Dumps a large list with the old "answer += std::to_string(...)" loop,
+// with to_string() (sized up front, one allocation) and with write_to(ostream)
+void to_string_benchmark()
+{
+    std::cout << "to_string_benchmark()" << std::endl;
+    const int COUNT = 5000000;
+    typedef std::chrono::steady_clock Clock;
+
+    List<int> list;
+    std::vector<int> values;
+    for (int i = 0; i < COUNT; i++) {
+        list.push_head(i * 37);
+        values.push_back((COUNT - 1 - i) * 37);
+    }
+
+    AllocationCounter allocations;
+    size_t before = allocations.count();
+    Clock::time_point start = Clock::now();
+    std::string appended = "{";
+    for (size_t i = 0; i < values.size(); i++) {
+        appended += std::to_string(values[i]);
+        if (i + 1 < values.size()) {
+            appended += ", ";
+        }
+    }
+    appended += "}";
+    double appendMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    size_t appendAllocations = allocations.count() - before;
+
+    before = allocations.count();
+    start = Clock::now();
+    std::string written = list.to_string();
+    double writeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    size_t writeAllocations = allocations.count() - before;
+
+    std::ostringstream stream;
+    start = Clock::now();
+    list.write_to(stream);
+    double streamMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::cout << "+= std::to_string:  " << appendMs << " ms, " << appendAllocations << " allocations" << std::endl;
+    std::cout << "to_string():        " << writeMs << " ms, " << writeAllocations << " allocations" << std::endl;
+    std::cout << "write_to(ostream):  " << streamMs << " ms" << std::endl;
+    std::cout << "same output: " << (appended == written && written == stream.str()) << std::endl;
+
+#if LDBL_MAX_10_EXP > 320
+    // too long for the to_chars buffer, both fall back to std::to_string.
+    // Only where long double is wider than double (not MSVC).
+    List<long double> huge{ LDBL_MAX, 2.5L };
+    std::ostringstream hugeStream;
+    huge.write_to(hugeStream);
+    std::string hugeWritten = huge.to_string();
+    std::cout << "LDBL_MAX: " << hugeWritten.size() << " chars, same output: " << (hugeStream.str() == hugeWritten) << std::endl;
+#endif
+}
+
+// contains() on a long-lived list with mostly negative lookups, without an
+// index, with a counting Bloom filter and with an exact hash multiset
+void membership_index_benchmark()
+{
+    std::cout << "membership_index_benchmark()" << std::endl;
+    const int COUNT = 100000;
+    const int LOOKUPS = 2000;
+    typedef std::chrono::steady_clock Clock;
+
+    List<int> plain;
+    List<int, CountingBloomIndex<int, 1 << 20>> bloom;
+    List<int, HashMultisetIndex<int>> hashed;
+    for (int i = 0; i < COUNT; i++) {
+        plain.push_head(2 * i);
+        bloom.push_head(2 * i);
+        hashed.push_head(2 * i);
+    }
+
+    // every tenth lookup is a hit
+    int found[3] = { 0, 0, 0 };
+    double ms[3];
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < LOOKUPS; i++) {
+        found[0] += plain.contains(i % 10 == 0 ? 2 * i : 2 * i + 1);
+    }
+    ms[0] = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    start = Clock::now();
+    for (int i = 0; i < LOOKUPS; i++) {
+        found[1] += bloom.contains(i % 10 == 0 ? 2 * i : 2 * i + 1);
+    }
+    ms[1] = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    start = Clock::now();
+    for (int i = 0; i < LOOKUPS; i++) {
+        found[2] += hashed.contains(i % 10 == 0 ? 2 * i : 2 * i + 1);
+    }
+    ms[2] = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::cout << "no index:           " << ms[0] << " ms, found " << found[0] << std::endl;
+    std::cout << "CountingBloomIndex: " << ms[1] << " ms, found " << found[1] << std::endl;
+    std::cout << "HashMultisetIndex:  " << ms[2] << " ms, found " << found[2] << std::endl;
+}
+
+// contains() miss and max over 50M elements, sequential and on 1 to 16 threads
+void parallel_scan_benchmark()
+{
+    std::cout << "parallel_scan_benchmark()" << std::endl;
+    const int COUNT = 50000000;
+    typedef std::chrono::steady_clock Clock;
+
+    List<int> list;
+    for (int i = 0; i < COUNT; i++) {
+        list.push_head(i);
+    }
+
+    Clock::time_point start = Clock::now();
+    bool found = list.contains(-1);
+    int max = *std::max_element(list.begin(), list.end());
+    double sequentialMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::cout << "sequential: " << sequentialMs << " ms (found " << found << ", max " << max << ")" << std::endl;
+
+    for (size_t threads = 1; threads <= 16; threads *= 2) {
+        ThreadPool pool(threads);
+        ListSegments<List<int>> segments(list, 4 * threads);
+
+        start = Clock::now();
+        found = parallel_contains(pool, segments, -1);
+        max = parallel_reduce(pool, segments, *list.begin(), [](int a, int b) { return std::max(a, b); });
+        double parallelMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        std::cout << threads << " threads: " << parallelMs << " ms (found " << found << ", max " << max << ")" << std::endl;
+    }
+}
+
+// Calorie queries over a vector<Food> against the same catalog in a FoodTable
+void food_table_benchmark()
+{
+    std::cout << "food_table_benchmark()" << std::endl;
+    const int COUNT = 5000000;
+    const char* NAMES[] = { "burger", "fries", "salad", "cola", "nuggets", "pie", "wrap", "shake" };
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<Food> foods;
+    foods.reserve(COUNT);
+    for (int i = 0; i < COUNT; i++) {
+        foods.emplace_back(NAMES[i % 8], static_cast<float>((i % 1000) * 7919 % 1000));
+    }
+    FoodTable table(foods.begin(), foods.end());
+
+    Clock::time_point start = Clock::now();
+    Food richest = *std::max_element(foods.begin(), foods.end());
+    size_t inRange = 0;
+    for (const Food& food : foods) {
+        inRange += food.calories() >= 200 && food.calories() <= 300;
+    }
+    double foodsMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    float maxCalories = table.max_calories();
+    size_t tableInRange = table.filter_calories(200, 300).size();
+    double tableMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    std::vector<size_t> top = table.top_k(5);
+    double sum = table.sum_calories();
+    float minCalories = table.min_calories();
+    double otherMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::cout << "vector<Food> max + range: " << foodsMs << " ms (" << COUNT / foodsMs / 1000 << " M items/s)" << std::endl;
+    std::cout << "FoodTable max + range:    " << tableMs << " ms (" << COUNT / tableMs / 1000 << " M items/s)" << std::endl;
+    std::cout << "FoodTable top_k + sum + min: " << otherMs << " ms" << std::endl;
+    std::cout << "same answers: " << (richest.calories() == maxCalories && inRange == tableInRange) << std::endl;
+    std::cout << "top: " << table.at(top[0]).name() << " " << table.calories(top[0])
+        << ", sum " << sum << ", min " << minCalories << ", distinct names " << table.distinct_names() << std::endl;
+}
+
+// Folds a long menu into one meal with Food::operator+ and with Combo
+void combo_benchmark()
+{
+    std::cout << "combo_benchmark()" << std::endl;
+    const int ITEMS = 2000;
+    const int ROUNDS = 20;
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<Food> menu;
+    for (int i = 0; i < ITEMS; i++) {
+        menu.emplace_back("item" + std::to_string(i), static_cast<float>(i % 97));
+    }
+
+    AllocationCounter allocations;
+    size_t before = allocations.count();
+    Clock::time_point start = Clock::now();
+    Food folded = menu[0];
+    for (int round = 0; round < ROUNDS; round++) {
+        folded = menu[0];
+        for (int i = 1; i < ITEMS; i++) {
+            folded = folded + menu[i];
+        }
+    }
+    double foodMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / ROUNDS;
+    size_t foodAllocations = (allocations.count() - before) / ROUNDS;
+
+    before = allocations.count();
+    start = Clock::now();
+    Combo combo(menu[0]);
+    for (int round = 0; round < ROUNDS; round++) {
+        combo = Combo(menu[0]);
+        for (int i = 1; i < ITEMS; i++) {
+            combo = combo + menu[i];
+        }
+        combo.name();
+    }
+    double comboMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / ROUNDS;
+    size_t comboAllocations = (allocations.count() - before) / ROUNDS;
+
+    std::cout << "Food::operator+ fold: " << foodMs << " ms, " << foodAllocations << " allocations" << std::endl;
+    std::cout << "Combo fold + name():  " << comboMs << " ms, " << comboAllocations << " allocations" << std::endl;
+    std::cout << "same meal: " << (combo.to_food() == folded) << std::endl;
+}
+
+// Brute force: tries every subset in catalog order, cutting branches that go
+// over the budget, and keeps the best total. Gives up after maxVisits subsets.
+static void brute_force_meals(const std::vector<Food>& catalog, size_t next, double total, float budget,
+    double& best, size_t& visits, size_t maxVisits)
+{
+    if (++visits > maxVisits) {
+        return;
+    }
+    if (total > best) {
+        best = total;
+    }
+    for (size_t i = next; i < catalog.size() && visits <= maxVisits; i++) {
+        if (total + catalog[i].calories() <= budget) {
+            brute_force_meals(catalog, i + 1, total + catalog[i].calories(), budget, best, visits, maxVisits);
+        }
+    }
+}
+
+// Closest meal under a 2000 calorie budget at 40, 200 and 2000 items.
+// Calories are multiples of 0.5, so a 0.5 resolution makes the search exact.
+void meal_search_benchmark()
+{
+    std::cout << "meal_search_benchmark()" << std::endl;
+    const float BUDGET = 2000;
+    const size_t TOP = 5;
+    const size_t MAX_VISITS = 5000000;
+    const size_t SIZES[] = { 40, 200, 2000 };
+    typedef std::chrono::steady_clock Clock;
+
+    for (size_t size : SIZES) {
+        std::vector<Food> catalog;
+        for (size_t i = 0; i < size; i++) {
+            catalog.emplace_back("item" + std::to_string(i), static_cast<float>(150 + (i * 7919) % 701) + 0.5f);
+        }
+
+        double bruteBest = 0;
+        size_t visits = 0;
+        Clock::time_point start = Clock::now();
+        brute_force_meals(catalog, 0, 0, BUDGET, bruteBest, visits, MAX_VISITS);
+        double bruteMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        MealSearch search(catalog, std::max(1u, std::thread::hardware_concurrency()));
+        start = Clock::now();
+        std::vector<Meal> meals = search.closest(BUDGET, TOP, MealSearch::Method::Automatic, 0.5f);
+        double searchMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::cout << size << " items: brute force " << bruteMs << " ms"
+            << (visits > MAX_VISITS ? " (gave up)" : "") << ", best " << bruteBest
+            << "; MealSearch " << searchMs << " ms, best " << (meals.empty() ? 0 : meals[0].food.calories())
+            << " from " << (meals.empty() ? 0 : meals[0].items.size()) << " items" << std::endl;
+    }
+}
+// Element for intrusive_list_benchmark(), carries its own link
+struct Reading : ListHook<Reading> {
+    int value;
+
+    explicit Reading(int value = 0) : value{ value } {}
+
+    bool operator==(const Reading& rhs) const { return value == rhs.value; }
+    bool operator>(const Reading& rhs) const { return value > rhs.value; }
+};
+
+std::string to_string(const Reading& reading)
+{
+    return std::to_string(reading.value);
+}
+
+// Links readings that already sit in a vector into an IntrusiveList, against
+// copying them into List<Reading> nodes
+void intrusive_list_benchmark()
+{
+    std::cout << "intrusive_list_benchmark()" << std::endl;
+    const int COUNT = 1000000;
+    const int ROUNDS = 10;
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<Reading> readings;
+    readings.reserve(COUNT);
+    for (int i = 0; i < COUNT; i++) {
+        readings.emplace_back((i % 1000) * 7919 % 1000);
+    }
+
+    AllocationCounter allocations;
+    size_t before = allocations.count();
+    Clock::time_point start = Clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        List<Reading> list;
+        for (Reading& reading : readings) {
+            list.push_head(reading);
+        }
+        while (!list.empty()) {
+            list.pop_head();
+        }
+    }
+    double listMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / ROUNDS;
+    size_t listAllocations = (allocations.count() - before) / ROUNDS;
+
+    before = allocations.count();
+    start = Clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        IntrusiveList<Reading> list;
+        for (Reading& reading : readings) {
+            list.push_head(reading);
+        }
+        while (!list.empty()) {
+            list.pop_head();
+        }
+    }
+    double intrusiveMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / ROUNDS;
+    size_t intrusiveAllocations = (allocations.count() - before) / ROUNDS;
+
+    std::cout << "List<Reading> push/pop " << COUNT << ":          " << listMs << " ms, " << listAllocations << " allocations" << std::endl;
+    std::cout << "IntrusiveList<Reading> push/pop " << COUNT << ": " << intrusiveMs << " ms, " << intrusiveAllocations << " allocations" << std::endl;
+
+    IntrusiveList<Reading> small;
+    for (int i = 0; i < 5; i++) {
+        small.push_head(readings[i]);
+    }
+    std::cout << small.to_string() << std::endl;
+    small.reverse();
+    std::cout << small.to_string() << std::endl;
+    Reading& max = small.extract_max();
+    std::cout << "max " << max.value << ", contains it: " << small.contains(max) << ", "
+        << small.to_string() << std::endl;
+}
+
+// Builds, scans (contains miss) and destroys one short list
+template <typename Container>
+static double build_scan_ns(size_t size, size_t rounds, long long& checksum)
+{
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    for (size_t round = 0; round < rounds; round++) {
+        Container list;
+        for (size_t i = 0; i < size; i++) {
+            list.push_head(static_cast<int>(i + round));
+        }
+        checksum += list.contains(-1) + list.size();
+    }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / rounds;
+}
+
+// Short lists of 0 to 64 ints: List<int> against SmallList<int, 8> and
+// SmallList<int, 16>. Past N the small lists spill and catch up with List.
+void small_list_benchmark()
+{
+    std::cout << "small_list_benchmark()" << std::endl;
+    const size_t ROUNDS = 200000;
+    const size_t SIZES[] = { 0, 1, 2, 4, 6, 8, 10, 12, 16, 20, 24, 32, 48, 64 };
+
+    long long checksum = 0;
+    std::cout << "size  List  SmallList<8>  SmallList<16>  (ns per build + scan + destroy)" << std::endl;
+    for (size_t size : SIZES) {
+        double list = build_scan_ns<List<int>>(size, ROUNDS, checksum);
+        double small8 = build_scan_ns<SmallList<int, 8>>(size, ROUNDS, checksum);
+        double small16 = build_scan_ns<SmallList<int, 16>>(size, ROUNDS, checksum);
+        std::cout << size << "  " << list << "  " << small8 << "  " << small16 << std::endl;
+    }
+    std::cout << "checksum: " << checksum << std::endl;
+
+    SmallList<int, 4> small{ 1, 5, 3, 8, 2, 7 };
+    std::cout << small.to_string() << " inline: " << small.is_inline() << std::endl;
+    int max = small.extract_max();
+    small.reverse();
+    std::cout << "max " << max << ", reversed " << small.to_string() << " inline: " << small.is_inline() << std::endl;
+}
+
+// Merges per-thread partial lists into one: 1000 lists of 10k with concat,
+// against walking to the end of the merged list before every append, which
+// is what appending took without a tail pointer (only 100 lists, it is quadratic)
+void concat_benchmark()
+{
+    std::cout << "concat_benchmark()" << std::endl;
+    const int LISTS = 1000;
+    const int WALKED_LISTS = 100;
+    const int LENGTH = 10000;
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<List<int>> parts(LISTS);
+    for (int i = 0; i < LISTS; i++) {
+        for (int j = 0; j < LENGTH; j++) {
+            parts[i].push_tail(j);
+        }
+    }
+
+    Clock::time_point start = Clock::now();
+    List<int> walked;
+    size_t hops = 0;
+    for (int i = 0; i < WALKED_LISTS; i++) {
+        for (List<int>::const_iterator it = walked.begin(); it != walked.end(); ++it) {
+            hops++;
+        }
+        for (int element : parts[i]) {
+            walked.push_tail(element);
+        }
+    }
+    double walkedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    List<int> merged;
+    for (int i = 0; i < LISTS; i++) {
+        merged.concat(std::move(parts[i]));
+    }
+    double concatMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::cout << "walk + append " << WALKED_LISTS << " lists: " << walkedMs << " ms (" << hops << " hops)" << std::endl;
+    std::cout << "concat " << LISTS << " lists:         " << concatMs << " ms, " << merged.size() << " elements" << std::endl;
+
+    List<int> front{ 1, 2 };
+    List<int> back{ 5, 6 };
+    List<int> middle{ 3, 4 };
+    middle.splice_front(std::move(front));
+    middle.concat(std::move(back));
+    middle.push_tail(7);
+    middle.reverse();
+    std::cout << middle.to_string() << " tail " << middle.tail() << std::endl;
+    // should be {7, 6, 5, 4, 3, 2, 1} tail 1
+
+    // absorbing a pool whose free list is empty (its newest chunk is full
+    // and nothing was popped) must keep the free slots already collected
+    List<int> a;
+    a.push_head(1);
+    a.pop_head();
+    List<int> b;
+    for (int i = 0; i < 64; i++) {
+        b.push_head(i);
+    }
+    a.concat(std::move(b));
+    List<int> c;
+    c.push_head(1);
+    c.push_head(2);
+    c.pop_head();
+    a.concat(std::move(c));
+    List<int> d;
+    for (int i = 0; i < 64; i++) {
+        d.push_head(i);
+    }
+    a.splice_front(std::move(d));
+    for (int i = 0; i < 200; i++) {
+        a.push_head(i);
+        a.push_tail(i);
+    }
+    assert(a.size() == 64 + 1 + 64 + 400);
+    while (!a.empty()) {
+        a.pop_head();
+    }
+    std::cout << "concat/splice of full pools: ok" << std::endl;
+}
+
+// contains() on List<int> (linear walk) against SortedList<int> (skip list)
+// at 1k, 10k and 100k elements, half the lookups missing
+void sorted_list_benchmark()
+{
+    std::cout << "sorted_list_benchmark()" << std::endl;
+    const int SIZES[] = { 1000, 10000, 100000 };
+    const int LOOKUPS = 2000;
+    typedef std::chrono::steady_clock Clock;
+
+    for (int size : SIZES) {
+        List<int> list;
+        SortedList<int> sorted;
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < size; i++) {
+            sorted.insert_sorted(2 * ((i % 1000) * 7919 % 1000 + 1000 * (i / 1000)));
+        }
+        double insertMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        for (int i = 0; i < size; i++) {
+            list.push_head(2 * ((i % 1000) * 7919 % 1000 + 1000 * (i / 1000)));
+        }
+
+        size_t found = 0;
+        start = Clock::now();
+        for (int i = 0; i < LOOKUPS; i++) {
+            found += list.contains((i * 7919) % (2 * size));
+        }
+        double listUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / LOOKUPS;
+
+        size_t sortedFound = 0;
+        start = Clock::now();
+        for (int i = 0; i < LOOKUPS; i++) {
+            sortedFound += sorted.contains((i * 7919) % (2 * size));
+        }
+        double sortedUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / LOOKUPS;
+
+        std::cout << size << " elements: List contains " << listUs << " us, SortedList contains " << sortedUs
+            << " us (found " << found << " / " << sortedFound << "), " << size << " insert_sorted " << insertMs << " ms" << std::endl;
+    }
+
+    SortedList<int> small{ 3, 1, 4, 1, 5, 9, 2, 6 };
+    std::cout << small.to_string() << " max " << small.extract_max() << std::endl;
+    small.reverse();
+    small.insert_sorted(7);
+    std::cout << small.to_string() << std::endl;
+    // should print {9, 6, 5, 4, 3, 2, 1, 1} max 9, then {1, 1, 2, 3, 4, 5, 6, 7}
+}
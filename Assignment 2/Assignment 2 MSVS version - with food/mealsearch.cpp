@@ -0,0 +1,228 @@
+#include "mealsearch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Subset of one half of the catalog, bit i set when item i of that half is used
+struct HalfSum {
+    double calories;
+    uint64_t mask;
+};
+
+// All 2^count subset sums of calories[first, first + count)
+std::vector<HalfSum> subset_sums(const std::vector<Food>& catalog, size_t first, size_t count)
+{
+    std::vector<HalfSum> sums(size_t(1) << count);
+    sums[0] = HalfSum{ 0.0, 0 };
+    for (size_t i = 0; i < count; i++) {
+        size_t filled = size_t(1) << i;
+        for (size_t mask = 0; mask < filled; mask++) {
+            sums[filled + mask] = HalfSum{ sums[mask].calories + catalog[first + i].calories(), filled + mask };
+        }
+    }
+    return sums;
+}
+
+// Rows longer than this many words are updated on the thread pool
+const size_t PARALLEL_ROW_WORDS = 1 << 14;
+
+// Most bits the DP table may take before closest() refuses: 128 MiB
+const size_t MAX_TABLE_BITS = size_t(1) << 30;
+
+// Bits in the DP table for items items, one row of capacity + 1 bits each
+// rounded up to words, or SIZE_MAX if that is over MAX_TABLE_BITS anyway
+size_t table_bits(size_t items, float budget, float resolution)
+{
+    double capacity = std::floor(budget / resolution);
+    if (!(capacity < double(MAX_TABLE_BITS))) {
+        return SIZE_MAX;
+    }
+    size_t rowBits = (static_cast<size_t>(capacity) / 64 + 1) * 64;
+    if (rowBits > MAX_TABLE_BITS / (items + 1)) {
+        return SIZE_MAX;
+    }
+    return (items + 1) * rowBits;
+}
+
+}
+
+MealSearch::MealSearch(const std::vector<Food>& catalog, size_t threads)
+    : m_catalog{ catalog }, m_pool{ threads }
+{
+    for (const Food& food : m_catalog) {
+        if (food.calories() < 0) {
+            throw std::invalid_argument("MealSearch needs non-negative calories");
+        }
+    }
+}
+
+std::vector<Meal> MealSearch::closest(float budget, size_t k, Method method, float resolution) const
+{
+    if (k == 0 || m_catalog.empty() || budget < 0) {
+        return std::vector<Meal>();
+    }
+    if (method != Method::MeetInTheMiddle && !(resolution > 0)) {
+        throw std::invalid_argument("resolution must be positive");
+    }
+    if (method == Method::Automatic) {
+        bool tableFits = table_bits(m_catalog.size(), budget, resolution) <= MAX_TABLE_BITS;
+        method = tableFits || m_catalog.size() > MAX_EXACT_ITEMS ? Method::Dynamic : Method::MeetInTheMiddle;
+    }
+    if (method == Method::MeetInTheMiddle) {
+        if (m_catalog.size() > MAX_EXACT_ITEMS) {
+            throw std::length_error("Catalog too large for meet in the middle");
+        }
+        return meet_in_the_middle(budget, k);
+    }
+    return dynamic(budget, k, resolution);
+}
+
+Meal MealSearch::make_meal(std::vector<size_t> items) const
+{
+    Food food = m_catalog[items[0]];
+    for (size_t i = 1; i < items.size(); i++) {
+        food = food + m_catalog[items[i]];
+    }
+    return Meal{ std::move(items), std::move(food) };
+}
+
+// Every left subset is paired with the right subsets in descending order of
+// their sum; a heap holding the next pair for each left subset yields totals
+// in descending order, so the first k distinct totals are the answer.
+std::vector<Meal> MealSearch::meet_in_the_middle(float budget, size_t k) const
+{
+    size_t leftCount = m_catalog.size() / 2;
+    size_t rightCount = m_catalog.size() - leftCount;
+    std::vector<HalfSum> left;
+    std::vector<HalfSum> right;
+    m_pool.parallel_for(2, [&](size_t half) {
+        if (half == 0) {
+            left = subset_sums(m_catalog, 0, leftCount);
+        }
+        else {
+            right = subset_sums(m_catalog, leftCount, rightCount);
+            std::sort(right.begin(), right.end(),
+                [](const HalfSum& a, const HalfSum& b) { return a.calories < b.calories; });
+        }
+    });
+
+    // (total, left index, right index) with the largest total on top
+    typedef std::pair<double, std::pair<size_t, size_t>> Candidate;
+    std::priority_queue<Candidate> candidates;
+    for (size_t l = 0; l < left.size(); l++) {
+        double room = budget - left[l].calories;
+        auto fits = std::upper_bound(right.begin(), right.end(), room,
+            [](double value, const HalfSum& sum) { return value < sum.calories; });
+        if (fits != right.begin()) {
+            size_t r = fits - right.begin() - 1;
+            candidates.push(Candidate(left[l].calories + right[r].calories, std::make_pair(l, r)));
+        }
+    }
+
+    std::vector<Meal> meals;
+    double lastTotal = -1;
+    while (!candidates.empty() && meals.size() < k) {
+        Candidate best = candidates.top();
+        candidates.pop();
+        size_t l = best.second.first;
+        size_t r = best.second.second;
+        if (r > 0) {
+            candidates.push(Candidate(left[l].calories + right[r - 1].calories, std::make_pair(l, r - 1)));
+        }
+        if ((left[l].mask | right[r].mask) == 0 || best.first == lastTotal) {
+            continue;                                   // empty meal, or a total we already have
+        }
+        std::vector<size_t> items;
+        for (size_t i = 0; i < leftCount; i++) {
+            if (left[l].mask & (uint64_t(1) << i)) items.push_back(i);
+        }
+        for (size_t i = 0; i < rightCount; i++) {
+            if (right[r].mask & (uint64_t(1) << i)) items.push_back(leftCount + i);
+        }
+        Meal meal = make_meal(std::move(items));
+        if (meal.food.calories() > budget) {
+            continue;                                   // within budget in double, rounded over it in float
+        }
+        lastTotal = best.first;
+        meals.push_back(std::move(meal));
+    }
+    return meals;
+}
+
+// reach[i] has bit s set when some subset of the first i items totals s units.
+// reach[i + 1] = reach[i] | (reach[i] << weight[i]), one shift-or per item.
+std::vector<Meal> MealSearch::dynamic(float budget, size_t k, float resolution) const
+{
+    size_t n = m_catalog.size();
+    if (table_bits(n, budget, resolution) > MAX_TABLE_BITS) {
+        throw std::length_error("Budget too large for this resolution");
+    }
+    size_t capacity = static_cast<size_t>(std::floor(budget / resolution));
+    size_t words = capacity / 64 + 1;
+    std::vector<size_t> weight(n);
+    for (size_t i = 0; i < n; i++) {
+        // rounded up, so every meal found really is within budget
+        weight[i] = static_cast<size_t>(std::ceil(m_catalog[i].calories() / resolution - 1e-6));
+    }
+
+    std::vector<uint64_t> reach((n + 1) * words, 0);
+    reach[0] = 1;                                       // the empty meal totals 0
+    uint64_t lastWordMask = capacity % 64 == 63 ? ~uint64_t(0) : (uint64_t(1) << (capacity % 64 + 1)) - 1;
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t* before = &reach[i * words];
+        uint64_t* after = &reach[(i + 1) * words];
+        size_t wordShift = weight[i] / 64;
+        size_t bitShift = weight[i] % 64;
+        auto update = [=](size_t first, size_t last) {
+            for (size_t w = first; w < last; w++) {
+                uint64_t shifted = 0;
+                if (w >= wordShift) {
+                    shifted = before[w - wordShift] << bitShift;
+                    if (bitShift != 0 && w > wordShift) {
+                        shifted |= before[w - wordShift - 1] >> (64 - bitShift);
+                    }
+                }
+                after[w] = before[w] | shifted;
+            }
+        };
+        if (words >= PARALLEL_ROW_WORDS && m_pool.size() > 1) {
+            size_t parts = m_pool.size();
+            m_pool.parallel_for(parts, [&](size_t part) {
+                update(words * part / parts, words * (part + 1) / parts);
+            });
+        }
+        else {
+            update(0, words);
+        }
+        after[words - 1] &= lastWordMask;
+    }
+
+    std::vector<Meal> meals;
+    const uint64_t* last = &reach[n * words];
+    for (size_t total = capacity; total > 0 && meals.size() < k; total--) {
+        if ((last[total / 64] >> (total % 64) & 1) == 0) {
+            continue;
+        }
+        // walk back through the rows: if the total was already reachable without item i, skip it
+        std::vector<size_t> items;
+        size_t remaining = total;
+        for (size_t i = n; i-- > 0 && remaining > 0;) {
+            const uint64_t* row = &reach[i * words];
+            if ((row[remaining / 64] >> (remaining % 64) & 1) == 0) {
+                items.push_back(i);
+                remaining -= weight[i];
+            }
+        }
+        std::reverse(items.begin(), items.end());
+        Meal meal = make_meal(std::move(items));
+        if (meal.food.calories() <= budget) {
+            meals.push_back(std::move(meal));
+        }
+    }
+    return meals;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+#include "food.h"
+#include "parallellist.hpp"
+
+// One meal found by MealSearch: the catalog indices it uses, in catalog
+// order, and the Food you get by folding them with operator+.
+struct Meal {
+    std::vector<size_t> items;
+    Food food;
+};
+
+// Finds the meals (non-empty subsets of a catalog) whose total calories are
+// closest to a budget without going over it. Returns at most one meal per
+// distinct total, closest first. Totals are ranked exactly, but a meal is
+// only returned if its Food, folded in float, is within budget too.
+//
+// Two methods:
+//  - meet in the middle: exact, enumerates both halves of the catalog
+//    (2^(n/2) sums each, plus a heap as large as the left half), so only
+//    for catalogs up to MAX_EXACT_ITEMS;
+//  - dynamic programming: calories are rounded up to multiples of resolution
+//    and one bitset row of reachable totals is kept per item, O(n * budget /
+//    resolution) bits. Rounding up keeps every meal within budget, but meals
+//    within about items * resolution of the budget can be missed, so use a
+//    finer resolution for closer answers. Row updates are split across the
+//    thread pool when rows are long. A table over 128 MiB is refused with
+//    std::length_error.
+// Calories must not be negative.
+class MealSearch {
+public:
+    enum class Method { Automatic, MeetInTheMiddle, Dynamic };
+
+    static const size_t MAX_EXACT_ITEMS = 24;
+
+    explicit MealSearch(const std::vector<Food>& catalog, size_t threads = 1);
+
+    // Up to k meals with total calories <= budget, closest to budget first.
+    // Automatic picks dynamic programming whenever its table fits, and meet
+    // in the middle only for small catalogs whose table doesn't. Safe to call
+    // from several threads; their parallel steps take turns on the pool.
+    std::vector<Meal> closest(float budget, size_t k, Method method = Method::Automatic,
+                              float resolution = 1.0f) const;
+
+private:
+    std::vector<Food> m_catalog;
+    mutable ThreadPool m_pool;
+
+    std::vector<Meal> meet_in_the_middle(float budget, size_t k) const;
+    std::vector<Meal> dynamic(float budget, size_t k, float resolution) const;
+
+    // Folds the items with Food::operator+
+    Meal make_meal(std::vector<size_t> items) const;
+};
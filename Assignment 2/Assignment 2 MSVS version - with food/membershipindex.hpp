@@ -0,0 +1,144 @@
+#ifndef MEMBERSHIP_INDEX_H
+#define MEMBERSHIP_INDEX_H
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Membership indexes for List<T, Index>. The list calls add() for every
+// element it gains and remove() for every element it loses, and contains()
+// asks may_contain() before walking. When may_contain() is false the element
+// is definitely absent; when the index is exact a true answer is final too.
+// absorb() takes over another index's elements when two lists are joined.
+// Moving an index must not allocate and must leave the source empty: a
+// moved List<T, Index> moves its index.
+
+// Default: no index, contains() always walks. Empty, so List<T> stores nothing for it.
+template <typename T> struct NoMembershipIndex {
+  static const bool exact = false;
+
+  void add(const T &) {}
+  void remove(const T &) {}
+  bool may_contain(const T &) const { return true; }
+  void absorb(NoMembershipIndex &) {}
+};
+
+// Counting Bloom filter over COUNTERS 16-bit counters with PROBES probes per
+// element. Negative lookups are O(1); a positive answer still needs a walk.
+// A counter that saturates is never decremented again, which keeps the
+// filter correct at the cost of extra false positives.
+template <typename T, size_t COUNTERS = 4096, size_t PROBES = 4> class CountingBloomIndex {
+private:
+  static_assert((COUNTERS & (COUNTERS - 1)) == 0, "COUNTERS must be a power of two");
+  static const uint16_t SATURATED = 0xFFFF;
+
+  std::vector<uint16_t> m_counters; // on the heap so big filters don't sit in the List object;
+                                    // empty until the first add, and again once moved from
+
+  // Double hashing: probe i lands on h1 + i * h2
+  static void hashes(const T &element, size_t &h1, size_t &h2) {
+    h1 = std::hash<T>()(element);
+    h2 = (h1 * 0x9E3779B97F4A7C15ull) >> 17 | 1;
+  }
+
+public:
+  static const bool exact = false;
+
+  CountingBloomIndex() {}
+
+  void add(const T &element) {
+    if (m_counters.empty()) {
+      m_counters.assign(COUNTERS, 0);
+    }
+    size_t h1, h2;
+    hashes(element, h1, h2);
+    for (size_t i = 0; i < PROBES; i++) {
+      uint16_t &counter = m_counters[(h1 + i * h2) & (COUNTERS - 1)];
+      if (counter != SATURATED) counter++;
+    }
+  }
+
+  void remove(const T &element) {
+    if (m_counters.empty()) return;
+    size_t h1, h2;
+    hashes(element, h1, h2);
+    for (size_t i = 0; i < PROBES; i++) {
+      uint16_t &counter = m_counters[(h1 + i * h2) & (COUNTERS - 1)];
+      if (counter != SATURATED && counter != 0) counter--; // 0: never added, don't wrap to SATURATED
+    }
+  }
+
+  bool may_contain(const T &element) const {
+    if (m_counters.empty()) return false;
+    size_t h1, h2;
+    hashes(element, h1, h2);
+    for (size_t i = 0; i < PROBES; i++) {
+      if (m_counters[(h1 + i * h2) & (COUNTERS - 1)] == 0) return false;
+    }
+    return true;
+  }
+
+  // Adds other's counters to this one's, O(COUNTERS), and clears other
+  void absorb(CountingBloomIndex &other) {
+    if (other.m_counters.empty()) return;
+    if (m_counters.empty()) {
+      m_counters.swap(other.m_counters);
+      return;
+    }
+    for (size_t i = 0; i < COUNTERS; i++) {
+      size_t sum = size_t(m_counters[i]) + other.m_counters[i];
+      m_counters[i] = sum >= SATURATED ? SATURATED : uint16_t(sum);
+      other.m_counters[i] = 0;
+    }
+  }
+};
+
+// Exact multiset of the elements, so contains() never walks the list
+template <typename T> class HashMultisetIndex {
+private:
+  std::unordered_map<T, size_t> m_counts;
+
+public:
+  static const bool exact = true;
+
+  HashMultisetIndex() {}
+  HashMultisetIndex(const HashMultisetIndex &) = default;
+  HashMultisetIndex &operator=(const HashMultisetIndex &) = default;
+
+  // A moved-from unordered_map is only valid, make sure it is empty too
+  HashMultisetIndex(HashMultisetIndex &&other) noexcept : m_counts(std::move(other.m_counts)) {
+    other.m_counts.clear();
+  }
+  HashMultisetIndex &operator=(HashMultisetIndex &&other) noexcept {
+    if (this == &other) return *this;
+    m_counts = std::move(other.m_counts);
+    other.m_counts.clear();
+    return *this;
+  }
+
+  void add(const T &element) { m_counts[element]++; }
+
+  void remove(const T &element) {
+    auto it = m_counts.find(element);
+    if (it != m_counts.end() && --it->second == 0) {
+      m_counts.erase(it);
+    }
+  }
+
+  bool may_contain(const T &element) const { return m_counts.count(element) != 0; }
+
+  // Adds other's counts, O(distinct elements of the smaller index), and clears other
+  void absorb(HashMultisetIndex &other) {
+    if (m_counts.size() < other.m_counts.size()) {
+      m_counts.swap(other.m_counts);
+    }
+    for (const auto &entry : other.m_counts) {
+      m_counts[entry.first] += entry.second;
+    }
+    other.m_counts.clear();
+  }
+};
+
+#endif
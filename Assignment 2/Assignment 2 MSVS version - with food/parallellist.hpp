@@ -0,0 +1,169 @@
+#ifndef PARALLEL_LIST_H
+#define PARALLEL_LIST_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that run one batch of tasks at a time.
+// Batches submitted from several threads take turns.
+class ThreadPool {
+private:
+  std::vector<std::thread> m_workers;
+  std::mutex m_submit;  // held by the thread whose batch is running
+  std::mutex m_lock;
+  std::condition_variable m_wake;
+  std::condition_variable m_done;
+  std::function<void(size_t)> m_task;
+  size_t m_next;        // next task index to hand out
+  size_t m_count;       // tasks in the current batch
+  size_t m_finished;    // tasks of the current batch that returned
+  uint64_t m_batch;     // bumped for every batch so idle workers wake up
+  bool m_stop;
+
+  void work() {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (;;) {
+      m_wake.wait(lock, [&]() { return m_stop || m_batch != seen; });
+      if (m_stop) return;
+      seen = m_batch;
+      while (m_next < m_count) {
+        size_t index = m_next++;
+        lock.unlock();
+        m_task(index);
+        lock.lock();
+        if (++m_finished == m_count) {
+          m_done.notify_all();
+        }
+      }
+    }
+  }
+
+public:
+  explicit ThreadPool(size_t threads)
+      : m_next{0}, m_count{0}, m_finished{0}, m_batch{0}, m_stop{false} {
+    for (size_t i = 0; i < std::max<size_t>(threads, 1); i++) {
+      m_workers.emplace_back([this]() { work(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(m_lock);
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread &worker : m_workers) {
+      worker.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  size_t size() const { return m_workers.size(); }
+
+  // Runs task(0) .. task(count - 1) on the workers and waits for all of them.
+  // task must not throw.
+  void parallel_for(size_t count, std::function<void(size_t)> task) {
+    if (count == 0) return;
+    std::lock_guard<std::mutex> turn(m_submit);
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_task = std::move(task);
+    m_next = 0;
+    m_count = count;
+    m_finished = 0;
+    m_batch++;
+    m_wake.notify_all();
+    m_done.wait(lock, [&]() { return m_finished == m_count; });
+  }
+};
+
+// A list's chain cut into contiguous segments by one walk. The segments stay
+// valid for any number of parallel passes until the list is modified.
+template <typename Container> class ListSegments {
+public:
+  typedef typename Container::const_iterator const_iterator;
+
+  // Splits list into at most count segments of nearly equal length
+  ListSegments(const Container &list, size_t count) {
+    size_t length = (list.size() + count - 1) / std::max<size_t>(count, 1);
+    const_iterator it = list.begin();
+    m_bounds.push_back(it);
+    for (size_t walked = 0; it != list.end(); ++it, ++walked) {
+      if (walked == length) {
+        m_bounds.push_back(it);
+        walked = 0;
+      }
+    }
+    m_bounds.push_back(list.end());
+  }
+
+  size_t size() const { return m_bounds.size() - 1; }
+  const_iterator begin(size_t segment) const { return m_bounds[segment]; }
+  const_iterator end(size_t segment) const { return m_bounds[segment + 1]; }
+
+private:
+  std::vector<const_iterator> m_bounds;
+};
+
+// Folds every element into init with op, which must be associative. Each
+// segment is folded on its own and the partial results are combined in order.
+template <typename Container, typename T, typename Op>
+T parallel_reduce(ThreadPool &pool, const ListSegments<Container> &segments, T init, Op op) {
+  std::vector<T> partial(segments.size(), init);
+  std::vector<char> used(segments.size(), 0);
+  pool.parallel_for(segments.size(), [&](size_t segment) {
+    auto it = segments.begin(segment);
+    auto end = segments.end(segment);
+    if (it == end) return;
+    T result = *it;
+    for (++it; it != end; ++it) {
+      result = op(result, *it);
+    }
+    partial[segment] = result;
+    used[segment] = 1;
+  });
+  for (size_t segment = 0; segment < segments.size(); segment++) {
+    if (used[segment]) {
+      init = op(init, partial[segment]);
+    }
+  }
+  return init;
+}
+
+// Checks whether any element satisfies pred; segments stop early once any of them finds one
+template <typename Container, typename Pred>
+bool parallel_any_of(ThreadPool &pool, const ListSegments<Container> &segments, Pred pred) {
+  const size_t CHECK_EVERY = 1024;
+  std::atomic<bool> found{false};
+  pool.parallel_for(segments.size(), [&](size_t segment) {
+    size_t checked = 0;
+    for (auto it = segments.begin(segment); it != segments.end(segment); ++it) {
+      if (pred(*it)) {
+        found.store(true, std::memory_order_relaxed);
+        return;
+      }
+      if (++checked == CHECK_EVERY) {
+        if (found.load(std::memory_order_relaxed)) return;
+        checked = 0;
+      }
+    }
+  });
+  return found.load();
+}
+
+// Parallel List<T>::contains
+template <typename Container, typename T>
+bool parallel_contains(ThreadPool &pool, const ListSegments<Container> &segments, const T &element) {
+  return parallel_any_of(pool, segments, [&element](const T &value) { return value == element; });
+}
+
+#endif
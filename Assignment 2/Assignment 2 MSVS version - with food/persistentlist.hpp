@@ -0,0 +1,201 @@
+#ifndef PERSISTENT_LIST_H
+#define PERSISTENT_LIST_H
+
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+template <typename T> struct SharedNode {
+  T element;
+  SharedNode<T> *next; // the node owns one reference to next
+  size_t refs;         // lists and nodes pointing here
+
+  SharedNode(const T &element, SharedNode<T> *next) : element{element}, next{next}, refs{1} {}
+};
+
+// List<T> whose copies share their nodes. Each node is reference counted and
+// the tail behind any node is never changed while it is shared, so copying a
+// list is O(1) and push_head/pop_head only touch the copy's own head. Anything
+// that changes a shared node (extract_max, reverse) first copies the shared
+// part of the chain in front of the change. Like List<T>, a single list is not
+// thread-safe, and neither are copies of it used from different threads.
+template <typename T> class PersistentList {
+private:
+  size_t m_size;
+  SharedNode<T> *m_head;
+
+  void swap(PersistentList<T> &other) noexcept {
+    std::swap(m_head, other.m_head);
+    std::swap(m_size, other.m_size);
+  }
+
+  static SharedNode<T> *retain(SharedNode<T> *node) {
+    if (node != nullptr) node->refs++;
+    return node;
+  }
+
+  // Drops one reference, freeing nodes down the chain while they become unused
+  static void release(SharedNode<T> *node) {
+    while (node != nullptr && --node->refs == 0) {
+      SharedNode<T> *next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  // Copies the shared nodes in front of stop so every node from the head up to
+  // stop is owned by this list alone. Returns the link that points at stop.
+  SharedNode<T> **make_unique_until(SharedNode<T> *stop) {
+    SharedNode<T> **link = &m_head;
+    while (*link != stop) {
+      SharedNode<T> *node = *link;
+      if (node->refs > 1) {
+        SharedNode<T> *copy = new SharedNode<T>(node->element, retain(node->next));
+        node->refs--; // still shared, so this never frees it
+        *link = copy;
+        node = copy;
+      }
+      link = &node->next;
+    }
+    return link;
+  }
+
+  // Helper for to_string()
+  template <typename U>
+  std::string element_to_string(const U& element) const{
+      return std::to_string(element);
+  }
+  // Overload for std::string to surround with quotes.
+  std::string element_to_string(const std::string& element) const{
+      return "\"" + element + "\"";
+  }
+
+public:
+  // Constructs an empty container
+  PersistentList() : m_size{0}, m_head{nullptr} {}
+
+  // Constructs the container with the contents of the initializer list
+  PersistentList(std::initializer_list<T> init_list) : m_size{0}, m_head{nullptr} {
+    for (auto it = init_list.end(); it != init_list.begin();) {
+      push_head(*--it);
+    }
+  }
+
+  // Destructor, frees only the nodes no other copy still uses
+  ~PersistentList() { release(m_head); }
+
+  // Copy constructor, shares every node with other in O(1)
+  PersistentList(const PersistentList<T> &other)
+      : m_size{other.m_size}, m_head{retain(other.m_head)} {}
+
+  // Move constructor
+  PersistentList(PersistentList<T> &&other) noexcept : m_size{0}, m_head{nullptr} {
+    swap(other);
+  }
+
+  // Copy assignment
+  PersistentList<T> &operator=(const PersistentList<T> &other) {
+    PersistentList<T> temp(other);
+    temp.swap(*this);
+    return *this;
+  }
+
+  // Move assignment
+  PersistentList<T> &operator=(PersistentList<T> &&other) noexcept {
+    PersistentList<T> temp(std::move(other));
+    temp.swap(*this);
+    return *this;
+  }
+
+  // Returns the contents of the head node
+  const T& head() {
+    if (m_size <= 0) {
+      throw std::out_of_range("List is empty");
+    }
+    return m_head->element;
+  }
+
+  // Checks whether the container is empty
+  bool empty() const { return m_size == 0; }
+
+  // Returns the number of elements
+  size_t size() const { return m_size; }
+
+  // Inserts an element to the head, the new node takes over the list's reference to the old head
+  void push_head(const T& element) {
+    m_head = new SharedNode<T>(element, m_head);
+    m_size++;
+  }
+
+  // Removes the head element, other copies keep it
+  void pop_head() {
+    if (m_size <= 0) {
+      throw std::out_of_range("List is empty");
+    }
+    SharedNode<T> *node = m_head;
+    m_head = retain(node->next);
+    release(node);
+    m_size--;
+  }
+
+  // Checks whether the container contains the specified element
+  bool contains(const T& element) const {
+    for (SharedNode<T> *node = m_head; node != nullptr; node = node->next) {
+      if (node->element == element) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Extracts the maximum element (nearest to head for duplicates), copying
+  // only the shared nodes in front of it
+  T extract_max() {
+    if (empty()) {
+      throw std::out_of_range("List is empty");
+    }
+    SharedNode<T> *maximumNode = m_head;
+    for (SharedNode<T> *node = m_head->next; node != nullptr; node = node->next) {
+      if (node->element > maximumNode->element) {
+        maximumNode = node;
+      }
+    }
+    T max = maximumNode->element;
+
+    SharedNode<T> **link = make_unique_until(maximumNode);
+    *link = retain(maximumNode->next);
+    release(maximumNode);
+    m_size--;
+    return max;
+  }
+
+  // Reverse the container, copying whatever is shared
+  void reverse() {
+    make_unique_until(nullptr);
+    SharedNode<T> *prev = nullptr;
+    SharedNode<T> *curr = m_head;
+    while (curr != nullptr) {
+      SharedNode<T> *next = curr->next;
+      curr->next = prev;
+      prev = curr;
+      curr = next;
+    }
+    m_head = prev;
+  }
+
+  // Returns a std::string equivalent of the container
+  std::string to_string() const {
+    std::string answer = "{";
+    for (SharedNode<T> *node = m_head; node != nullptr; node = node->next) {
+      answer += element_to_string(node->element);
+      if (node->next != nullptr) {
+        answer += ", ";
+      }
+    }
+    answer += "}";
+    return answer;
+  }
+};
+
+#endif
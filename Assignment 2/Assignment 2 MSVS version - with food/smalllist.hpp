@@ -0,0 +1,286 @@
+#ifndef SMALL_LIST_H
+#define SMALL_LIST_H
+
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "linkedlist.hpp"
+
+// List<T> whose first N elements live inline in the list object itself, so a
+// list that never grows past N never touches the heap. Pushes past N spill to
+// pooled heap nodes in front of the inline part:
+//   head -> node -> ... -> node -> inline[count - 1] -> ... -> inline[0]
+// The inline slots always fill first: a node only exists while every slot is
+// in use, which keeps the oldest elements inline.
+template <typename T, size_t N = 8> class SmallList {
+  static_assert(N > 0, "SmallList needs at least one inline slot");
+
+private:
+  size_t m_size;
+  size_t m_inline_count; // used inline slots, [0, m_inline_count)
+  Node<T> *m_head;       // spilled nodes, newest first
+  NodePool<T> m_pool;
+  alignas(T) unsigned char m_inline[N][sizeof(T)];
+
+  T *slot(size_t index) { return reinterpret_cast<T *>(m_inline[index]); }
+  const T *slot(size_t index) const { return reinterpret_cast<const T *>(m_inline[index]); }
+
+  // Takes over other's elements; this list must be empty
+  void take(SmallList<T, N> &other) {
+    for (; m_inline_count < other.m_inline_count; m_inline_count++) {
+      new (slot(m_inline_count)) T(std::move(*other.slot(m_inline_count)));
+    }
+    std::swap(m_head, other.m_head);
+    m_pool.swap(other.m_pool);
+    m_size = other.m_size;
+    other.clear();
+  }
+
+  // Every element from head to tail, as pointers
+  std::vector<T *> elements() {
+    std::vector<T *> result;
+    result.reserve(m_size);
+    for (Node<T> *node = m_head; node != nullptr; node = node->next) {
+      result.push_back(&node->element);
+    }
+    for (size_t i = m_inline_count; i-- > 0;) {
+      result.push_back(slot(i));
+    }
+    return result;
+  }
+
+  // Helper for to_string()
+  template <typename U>
+  std::string element_to_string(const U& element) const{
+      return std::to_string(element);
+  }
+  // Overload for std::string to surround with quotes.
+  std::string element_to_string(const std::string& element) const{
+      return "\"" + element + "\"";
+  }
+
+public:
+  // Constructs an empty container
+  SmallList() : m_size{0}, m_inline_count{0}, m_head{nullptr} {}
+
+  // Constructs the container with the contents of the initializer list
+  SmallList(std::initializer_list<T> init_list) : SmallList() {
+    for (auto it = init_list.end(); it != init_list.begin();) {
+      push_head(*--it);
+    }
+  }
+
+  // Destructor
+  ~SmallList() { clear(); }
+
+  // Copy constructor, keeps the same inline/spilled layout
+  SmallList(const SmallList<T, N> &other) : SmallList() {
+    try {
+      for (; m_inline_count < other.m_inline_count; m_inline_count++) {
+        new (slot(m_inline_count)) T(*other.slot(m_inline_count));
+        m_size++;
+      }
+      Node<T> **link = &m_head;
+      for (Node<T> *node = other.m_head; node != nullptr; node = node->next) {
+        *link = m_pool.create(node->element);
+        link = &(*link)->next;
+        m_size++;
+      }
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  // Move constructor, moves the inline elements and takes the spilled nodes in O(1).
+  // noexcept when moving a T is, so containers of SmallLists move them on growth.
+  SmallList(SmallList<T, N> &&other) noexcept(std::is_nothrow_move_constructible<T>::value) : SmallList() {
+    take(other);
+  }
+
+  // Copy assignment
+  SmallList<T, N> &operator=(const SmallList<T, N> &other) {
+    if (this == &other) return *this;
+    SmallList<T, N> temp(other);
+    *this = std::move(temp);
+    return *this;
+  }
+
+  // Move assignment
+  SmallList<T, N> &operator=(SmallList<T, N> &&other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+    if (this == &other) return *this;
+    clear();
+    take(other);
+    return *this;
+  }
+
+  // Returns the contents of the head element
+  const T& head() {
+    if (m_size <= 0) {
+      throw std::out_of_range("List is empty");
+    }
+    return m_head != nullptr ? m_head->element : *slot(m_inline_count - 1);
+  }
+
+  // Checks whether the container is empty
+  bool empty() const { return m_size == 0; }
+
+  // Returns the number of elements
+  size_t size() const { return m_size; }
+
+  // True while no element has spilled to the heap
+  bool is_inline() const { return m_head == nullptr; }
+
+  // Inserts an element to the head, inline while there is a free slot
+  void push_head(const T& element) {
+    if (m_inline_count < N) {
+      new (slot(m_inline_count)) T(element);
+      m_inline_count++;
+    }
+    else {
+      m_head = m_pool.create(element, m_head);
+    }
+    m_size++;
+  }
+
+  // Removes the head element
+  void pop_head() {
+    if (m_size <= 0) {
+      throw std::out_of_range("List is empty");
+    }
+    if (m_head != nullptr) {
+      Node<T> *node = m_head;
+      m_head = m_head->next;
+      m_pool.destroy(node);
+    }
+    else {
+      slot(--m_inline_count)->~T();
+    }
+    m_size--;
+  }
+
+  // Removes every element; spilled nodes go back to the pool
+  void clear() {
+    while (m_head != nullptr) {
+      Node<T> *node = m_head;
+      m_head = m_head->next;
+      m_pool.destroy(node);
+    }
+    while (m_inline_count > 0) {
+      slot(--m_inline_count)->~T();
+    }
+    m_size = 0;
+  }
+
+  // Checks whether the container contains the specified element
+  bool contains(const T& element) const {
+    for (const Node<T> *node = m_head; node != nullptr; node = node->next) {
+      if (node->element == element) {
+        return true;
+      }
+    }
+    for (size_t i = 0; i < m_inline_count; i++) {
+      if (*slot(i) == element) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Extracts the maximum element (nearest to head for duplicates)
+  T extract_max() {
+    if (empty()) {
+      throw std::out_of_range("List is empty");
+    }
+
+    Node<T> **maxLink = nullptr;   // set when the maximum is a spilled node
+    size_t maxSlot = 0;            // otherwise its inline slot
+    const T *maxElement = nullptr;
+    for (Node<T> **link = &m_head; *link != nullptr; link = &(*link)->next) {
+      if (maxElement == nullptr || (*link)->element > *maxElement) {
+        maxElement = &(*link)->element;
+        maxLink = link;
+      }
+    }
+    for (size_t i = m_inline_count; i-- > 0;) {
+      if (maxElement == nullptr || *slot(i) > *maxElement) {
+        maxElement = slot(i);
+        maxLink = nullptr;
+        maxSlot = i;
+      }
+    }
+
+    if (maxLink != nullptr) {
+      Node<T> *node = *maxLink;
+      T max = std::move(node->element);
+      *maxLink = node->next;
+      m_pool.destroy(node);
+      m_size--;
+      return max;
+    }
+
+    // close the gap in the inline slots, then refill the top slot from the
+    // last spilled node, which sits right after it in list order
+    T max = std::move(*slot(maxSlot));
+    for (size_t i = maxSlot; i + 1 < m_inline_count; i++) {
+      *slot(i) = std::move(*slot(i + 1));
+    }
+    if (m_head == nullptr) {
+      slot(--m_inline_count)->~T();
+    }
+    else {
+      Node<T> **link = &m_head;
+      while ((*link)->next != nullptr) {
+        link = &(*link)->next;
+      }
+      *slot(m_inline_count - 1) = std::move((*link)->element);
+      m_pool.destroy(*link);
+      *link = nullptr;
+    }
+    m_size--;
+    return max;
+  }
+
+  // Reverse the container. Inline slots can't be relinked, so this swaps
+  // elements pairwise from both ends instead.
+  void reverse() {
+    if (m_head == nullptr) {
+      for (size_t i = 0, j = m_inline_count; i + 1 < j; i++, j--) {
+        std::swap(*slot(i), *slot(j - 1));
+      }
+      return;
+    }
+    std::vector<T *> order = elements();
+    for (size_t i = 0, j = order.size(); i + 1 < j; i++, j--) {
+      std::swap(*order[i], *order[j - 1]);
+    }
+  }
+
+  // Returns a std::string equivalent of the container
+  std::string to_string() const {
+    std::string answer = "{";
+    bool first = true;
+    for (const Node<T> *node = m_head; node != nullptr; node = node->next) {
+      if (!first) {
+        answer += ", ";
+      }
+      answer += element_to_string(node->element);
+      first = false;
+    }
+    for (size_t i = m_inline_count; i-- > 0;) {
+      if (!first) {
+        answer += ", ";
+      }
+      answer += element_to_string(*slot(i));
+      first = false;
+    }
+    answer += "}";
+    return answer;
+  }
+};
+
+#endif
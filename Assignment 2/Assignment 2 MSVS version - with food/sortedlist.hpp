@@ -0,0 +1,341 @@
+#ifndef SORTED_LIST_H
+#define SORTED_LIST_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "linkedlist.hpp"
+
+// Node of an express lane above the Node<T> chain. A node on lane 1 points
+// down at a chain node, a node on lane k > 1 at the node below it on lane k - 1.
+template <typename T> struct LaneNode {
+  LaneNode<T> *next;
+  LaneNode<T> *down; // nullptr on lane 1
+  Node<T> *node;     // the chain node this tower stands on
+
+  LaneNode(LaneNode<T> *next, LaneNode<T> *down, Node<T> *node) : next{next}, down{down}, node{node} {}
+};
+
+// List<T> kept sorted, largest element at the head, as a skip list: the
+// Node<T> chain holds every element and each lane above it skips ahead over
+// about 3 of every 4 nodes of the lane below. contains and insert_sorted
+// take O(log n) expected time, the maximum is always the head so
+// extract_max is O(1) expected: it only unlinks the head's tower, which
+// reaches 4/3 lanes on average.
+//
+// reverse() flips the order the list is read in (head, to_string,
+// pop_head) instead of relinking, so after it the head is the minimum and
+// insert_sorted keeps ascending order. extract_max still takes the maximum;
+// pop_head then has to find the tail's tower, O(log n) expected.
+template <typename T> class SortedList {
+private:
+  static const size_t MAX_LANES = 32;
+
+  typedef std::array<LaneNode<T> *, MAX_LANES> LanePath; // a node on every lane
+
+  size_t m_size;
+  Node<T> *m_head;                 // largest element
+  Node<T> *m_tail;                 // smallest element
+  std::vector<LaneNode<T> *> m_lanes; // first node of lane 1, 2, ...
+  NodePool<T> m_pool;
+  uint64_t m_random;               // xorshift state for tower heights
+  bool m_reversed;
+
+  void swap(SortedList<T> &other) noexcept {
+    std::swap(m_size, other.m_size);
+    std::swap(m_head, other.m_head);
+    std::swap(m_tail, other.m_tail);
+    m_lanes.swap(other.m_lanes);
+    m_pool.swap(other.m_pool);
+    std::swap(m_random, other.m_random);
+    std::swap(m_reversed, other.m_reversed);
+  }
+
+  // Number of lanes a new element's tower reaches, P(k or more) = 4^-k
+  size_t random_height() {
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 7;
+    m_random ^= m_random << 17;
+    uint64_t bits = m_random;
+    size_t height = 0;
+    while ((bits & 3) == 0 && height < MAX_LANES) {
+      height++;
+      bits >>= 2;
+    }
+    return height;
+  }
+
+  // Walks down from the top lane to the last node on every lane whose element
+  // goes before element (larger, or also equal when orEqual is set) and
+  // returns the last such chain node. If lanes is given, (*lanes)[k] gets the
+  // node found on lane k + 1. nullptr means none: the start of the lane.
+  Node<T> *search(const T &element, bool orEqual, LanePath *lanes) const {
+    auto goes_before = [&](const T &other) {
+      return orEqual ? !(other < element) : element < other;
+    };
+    LaneNode<T> *current = nullptr;
+    for (size_t lane = m_lanes.size(); lane-- > 0;) {
+      LaneNode<T> *next = current != nullptr ? current->next : m_lanes[lane];
+      while (next != nullptr && goes_before(next->node->element)) {
+        current = next;
+        next = next->next;
+      }
+      if (lanes != nullptr) (*lanes)[lane] = current;
+      if (lane > 0 && current != nullptr) current = current->down;
+    }
+    Node<T> *node = current != nullptr ? current->node : nullptr;
+    Node<T> *next = node != nullptr ? node->next : m_head;
+    while (next != nullptr && goes_before(next->element)) {
+      node = next;
+      next = next->next;
+    }
+    return node;
+  }
+
+  // Unlinks and frees node, given the node before it on the chain and the
+  // node before its tower on every lane. No lanes means the tower is at the
+  // start of every lane it reaches, as the head's is.
+  void unlink(Node<T> *before, Node<T> *node, const LanePath *lanes) {
+    for (size_t lane = 0; lane < m_lanes.size(); lane++) {
+      LaneNode<T> *previous = lanes != nullptr ? (*lanes)[lane] : nullptr;
+      LaneNode<T> **link = previous != nullptr ? &previous->next : &m_lanes[lane];
+      if (*link == nullptr || (*link)->node != node) break; // towers are contiguous from lane 1
+      LaneNode<T> *tower = *link;
+      *link = tower->next;
+      delete tower;
+    }
+    while (!m_lanes.empty() && m_lanes.back() == nullptr) {
+      m_lanes.pop_back();
+    }
+    if (before == nullptr) {
+      m_head = node->next;
+    }
+    else {
+      before->next = node->next;
+    }
+    if (m_tail == node) m_tail = before;
+    m_pool.destroy(node);
+    m_size--;
+  }
+
+  // Frees every lane node
+  void clear_lanes() {
+    for (LaneNode<T> *first : m_lanes) {
+      while (first != nullptr) {
+        LaneNode<T> *next = first->next;
+        delete first;
+        first = next;
+      }
+    }
+    m_lanes.clear();
+  }
+
+  // Helper for to_string()
+  template <typename U>
+  std::string element_to_string(const U& element) const{
+      return std::to_string(element);
+  }
+  // Overload for std::string to surround with quotes.
+  std::string element_to_string(const std::string& element) const{
+      return "\"" + element + "\"";
+  }
+
+public:
+  // Constructs an empty container
+  SortedList()
+      : m_size{0}, m_head{nullptr}, m_tail{nullptr}, m_random{0x9E3779B97F4A7C15ull}, m_reversed{false} {}
+
+  // Constructs the container with the contents of the initializer list, sorted
+  SortedList(std::initializer_list<T> init_list) : SortedList() {
+    for (const T &element : init_list) {
+      insert_sorted(element);
+    }
+  }
+
+  // Destructor
+  ~SortedList() {
+    clear_lanes();
+    while (m_head != nullptr) {
+      Node<T> *node = m_head;
+      m_head = m_head->next;
+      m_pool.destroy(node);
+    }
+  }
+
+  // Copy constructor, appends the elements in order and rebuilds the lanes
+  // with the same tower heights as other
+  SortedList(const SortedList<T> &other) : SortedList() {
+    m_random = other.m_random;
+    m_reversed = other.m_reversed;
+    std::vector<LaneNode<T> *> lastOnLane(other.m_lanes.size(), nullptr);
+    std::vector<LaneNode<T> *> otherNext(other.m_lanes); // next lane node of other to copy, per lane
+    m_lanes.assign(other.m_lanes.size(), nullptr);
+    for (Node<T> *node = other.m_head; node != nullptr; node = node->next) {
+      Node<T> *tower = m_pool.create(node->element);
+      if (m_tail == nullptr) {
+        m_head = tower;
+      }
+      else {
+        m_tail->next = tower;
+      }
+      m_tail = tower;
+      m_size++;
+      LaneNode<T> *below = nullptr;
+      for (size_t lane = 0; lane < otherNext.size() && otherNext[lane] != nullptr && otherNext[lane]->node == node; lane++) {
+        LaneNode<T> *copy = new LaneNode<T>(nullptr, below, tower);
+        if (lastOnLane[lane] == nullptr) {
+          m_lanes[lane] = copy;
+        }
+        else {
+          lastOnLane[lane]->next = copy;
+        }
+        lastOnLane[lane] = copy;
+        otherNext[lane] = otherNext[lane]->next;
+        below = copy;
+      }
+    }
+  }
+
+  // Move constructor
+  SortedList(SortedList<T> &&other) noexcept : SortedList() {
+    swap(other);
+  }
+
+  // Copy assignment
+  SortedList<T> &operator=(const SortedList<T> &other) {
+    if (this == &other) return *this;
+    SortedList<T> temp(other);
+    temp.swap(*this);
+    return *this;
+  }
+
+  // Move assignment
+  SortedList<T> &operator=(SortedList<T> &&other) noexcept {
+    if (this == &other) return *this;
+    SortedList<T> temp(std::move(other));
+    temp.swap(*this);
+    return *this;
+  }
+
+  // Returns the head element: the maximum, or the minimum after reverse()
+  const T& head() {
+    if (m_size <= 0) {
+      throw std::out_of_range("List is empty");
+    }
+    return m_reversed ? m_tail->element : m_head->element;
+  }
+
+  // Returns the maximum element in O(1)
+  const T& max() {
+    if (m_size <= 0) {
+      throw std::out_of_range("List is empty");
+    }
+    return m_head->element;
+  }
+
+  // Checks whether the container is empty
+  bool empty() const { return m_size == 0; }
+
+  // Returns the number of elements
+  size_t size() const { return m_size; }
+
+  // Inserts an element at its place in the order, after any equal elements
+  // already there (in descending order), O(log n) expected
+  void insert_sorted(const T& element) {
+    LanePath lanes;
+    Node<T> *before = search(element, true, &lanes);
+    Node<T> **link = before != nullptr ? &before->next : &m_head;
+    Node<T> *node = m_pool.create(element, *link);
+    *link = node;
+    if (node->next == nullptr) m_tail = node;
+    m_size++;
+
+    size_t height = random_height();
+    LaneNode<T> *below = nullptr;
+    for (size_t lane = 0; lane < height; lane++) {
+      if (lane == m_lanes.size()) {
+        m_lanes.push_back(nullptr);
+        lanes[lane] = nullptr;
+      }
+      LaneNode<T> **laneLink = lanes[lane] != nullptr ? &lanes[lane]->next : &m_lanes[lane];
+      below = new LaneNode<T>(*laneLink, below, node);
+      *laneLink = below;
+    }
+  }
+
+  // Removes the head element: the maximum in O(1) expected, or the minimum
+  // after reverse() in O(log n) expected plus the run of elements equal to it
+  void pop_head() {
+    if (m_size <= 0) {
+      throw std::out_of_range("List is empty");
+    }
+    if (!m_reversed) {
+      extract_max();
+      return;
+    }
+    // the last of the smallest elements: walk past every larger one, then along the equal run
+    LanePath lanes;
+    Node<T> *before = search(m_tail->element, false, &lanes);
+    Node<T> *next = before != nullptr ? before->next : m_head;
+    while (next != m_tail) {
+      before = next;
+      next = next->next;
+    }
+    for (size_t lane = 0; lane < m_lanes.size(); lane++) {
+      LaneNode<T> *laneNext = lanes[lane] != nullptr ? lanes[lane]->next : m_lanes[lane];
+      while (laneNext != nullptr && laneNext->node != m_tail) {
+        lanes[lane] = laneNext;
+        laneNext = laneNext->next;
+      }
+    }
+    unlink(before, m_tail, &lanes);
+  }
+
+  // Checks whether the container contains the specified element, O(log n) expected
+  bool contains(const T& element) const {
+    Node<T> *node = search(element, true, nullptr);
+    return node != nullptr && node->element == element;
+  }
+
+  // Extracts the maximum element in O(1) expected: it is the first chain
+  // node and the first node of every lane its tower reaches
+  T extract_max() {
+    if (empty()) {
+      throw std::out_of_range("List is empty");
+    }
+    T max = m_head->element;
+    unlink(nullptr, m_head, nullptr);
+    return max;
+  }
+
+  // Reverse the container, O(1)
+  void reverse() { m_reversed = !m_reversed; }
+
+  // Returns a std::string equivalent of the container
+  std::string to_string() const {
+    std::vector<const T *> order;
+    order.reserve(m_size);
+    for (Node<T> *node = m_head; node != nullptr; node = node->next) {
+      order.push_back(&node->element);
+    }
+    if (m_reversed) {
+      std::reverse(order.begin(), order.end());
+    }
+    std::string answer = "{";
+    for (size_t i = 0; i < order.size(); i++) {
+      if (i > 0) {
+        answer += ", ";
+      }
+      answer += element_to_string(*order[i]);
+    }
+    answer += "}";
+    return answer;
+  }
+};
+
+#endif
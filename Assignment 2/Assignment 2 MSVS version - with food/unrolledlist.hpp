@@ -0,0 +1,283 @@
+#ifndef UNROLLED_LIST_H
+#define UNROLLED_LIST_H
+
+#include <algorithm>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UNROLLED_LIST_SSE2
+#endif
+
+// A block of up to N elements. Elements sit at the back of the array, in
+// [N - count, N), so push_head fills the block towards index 0.
+template <typename T, size_t N> struct Block {
+  alignas(T) unsigned char storage[N * sizeof(T)];
+  size_t count;
+  Block<T, N> *next;
+
+  Block(Block<T, N> *next) : count{0}, next{next} {}
+
+  T *begin() { return reinterpret_cast<T *>(storage) + (N - count); }
+  T *end() { return reinterpret_cast<T *>(storage) + N; }
+  const T *begin() const { return reinterpret_cast<const T *>(storage) + (N - count); }
+  const T *end() const { return reinterpret_cast<const T *>(storage) + N; }
+};
+
+// Scans a block for element
+template <typename T>
+bool block_contains(const T *first, const T *last, const T &element) {
+  for (; first != last; ++first) {
+    if (*first == element) {
+      return true;
+    }
+  }
+  return false;
+}
+
+#ifdef UNROLLED_LIST_SSE2
+// int overload: compares four elements per instruction
+inline bool block_contains(const int *first, const int *last, const int &element) {
+  const __m128i needle = _mm_set1_epi32(element);
+  for (; last - first >= 4; first += 4) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(chunk, needle)) != 0) {
+      return true;
+    }
+  }
+  for (; first != last; ++first) {
+    if (*first == element) {
+      return true;
+    }
+  }
+  return false;
+}
+#endif
+
+// Same interface as List<T>, but each node (block) stores up to N elements
+// contiguously so scans touch one cache line per few elements instead of one
+// pointer hop per element.
+template <typename T, size_t N = 16> class UnrolledList {
+private:
+  size_t m_size;
+  Block<T, N> *m_head;
+
+  void swap(UnrolledList<T, N> &other) {
+    std::swap(m_head, other.m_head);
+    std::swap(m_size, other.m_size);
+  }
+
+  // Destroys the elements of a block and frees it
+  static void free_block(Block<T, N> *block) {
+    for (T *it = block->begin(); it != block->end(); ++it) {
+      it->~T();
+    }
+    delete block;
+  }
+
+  // Frees every block
+  void clear() {
+    while (m_head != nullptr) {
+      Block<T, N> *block = m_head;
+      m_head = m_head->next;
+      free_block(block);
+    }
+    m_size = 0;
+  }
+
+  // Helper for to_string()
+  template <typename U>
+  std::string element_to_string(const U& element) const{
+      return std::to_string(element);
+  }
+  // Overload for std::string to surround with quotes.
+  std::string element_to_string(const std::string& element) const{
+      return "\"" + element + "\"";
+  }
+
+public:
+  // Constructs an empty container
+  UnrolledList() : m_size{0}, m_head{nullptr} {}
+
+  // Constructs the container with the contents of the initializer list
+  UnrolledList(std::initializer_list<T> init_list) : m_size{0}, m_head{nullptr} {
+    for (auto it = init_list.end(); it != init_list.begin();) {
+      push_head(*--it);
+    }
+  }
+
+  // Destructor
+  ~UnrolledList() { clear(); }
+
+  // Copy constructor, copies block by block keeping the same layout
+  UnrolledList(const UnrolledList<T, N> &other) : m_size{0}, m_head{nullptr} {
+    Block<T, N> *tail = nullptr;
+    try {
+      for (Block<T, N> *block = other.m_head; block != nullptr; block = block->next) {
+        Block<T, N> *copy = new Block<T, N>(nullptr);
+        if (tail == nullptr) {
+          m_head = copy;
+        }
+        else {
+          tail->next = copy;
+        }
+        tail = copy;
+        // fill from the back so a throwing copy leaves a valid block
+        for (const T *it = block->end(); it != block->begin();) {
+          new (copy->begin() - 1) T(*--it);
+          copy->count++;
+          m_size++;
+        }
+      }
+    } catch (...) {
+      clear();
+      throw;
+    }
+  }
+
+  // Copy assignment
+  UnrolledList<T, N> &operator=(const UnrolledList<T, N> &other) {
+    if (this == &other) return *this;
+    UnrolledList<T, N> temp(other);
+    temp.swap(*this);
+    return *this;
+  }
+
+  // Returns the contents of the head element
+  const T& head() {
+    if (m_size <= 0) {
+      throw std::out_of_range("List is empty");
+    }
+    return *m_head->begin();
+  }
+
+  // Checks whether the container is empty
+  bool empty() const { return m_size == 0; }
+
+  // Returns the number of elements
+  size_t size() const { return m_size; }
+
+  // Inserts an element to the head, starting a new block when the head block is full
+  void push_head(const T& element) {
+    if (m_head != nullptr && m_head->count < N) {
+      new (m_head->begin() - 1) T(element);
+      m_head->count++;
+      m_size++;
+      return;
+    }
+    // the new block is only linked once it holds the element, so a throwing
+    // copy doesn't leave an empty block at the head
+    Block<T, N> *block = new Block<T, N>(m_head);
+    try {
+      new (block->begin() - 1) T(element);
+    } catch (...) {
+      delete block;
+      throw;
+    }
+    block->count++;
+    m_head = block;
+    m_size++;
+  }
+
+  // Removes the head element
+  void pop_head() {
+    if (m_size <= 0) {
+      throw std::out_of_range("List is empty");
+    }
+    m_head->begin()->~T();
+    m_head->count--;
+    if (m_head->count == 0) {
+      Block<T, N> *block = m_head;
+      m_head = m_head->next;
+      delete block;
+    }
+    m_size--;
+  }
+
+  // Checks whether the container contains the specified element
+  bool contains(const T& element) const {
+    for (const Block<T, N> *block = m_head; block != nullptr; block = block->next) {
+      if (block_contains(block->begin(), block->end(), element)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Extracts the maximum element (nearest to head for duplicates)
+  T extract_max() {
+    if (empty()) {
+      throw std::out_of_range("List is empty");
+    }
+
+    Block<T, N> *maxBlock = m_head;
+    Block<T, N> *beforeMaxBlock = nullptr;
+    T *maxElement = m_head->begin();
+    Block<T, N> *prevBlock = nullptr;
+    for (Block<T, N> *block = m_head; block != nullptr; block = block->next) {
+      for (T *it = block->begin(); it != block->end(); ++it) {
+        if (*it > *maxElement) {
+          maxElement = it;
+          maxBlock = block;
+          beforeMaxBlock = prevBlock;
+        }
+      }
+      prevBlock = block;
+    }
+    T max = std::move(*maxElement);
+
+    // close the gap by shifting the elements in front of it back by one
+    T *first = maxBlock->begin();
+    std::move_backward(first, maxElement, maxElement + 1);
+    first->~T();
+    maxBlock->count--;
+    if (maxBlock->count == 0) {
+      if (beforeMaxBlock == nullptr) {
+        m_head = maxBlock->next;
+      }
+      else {
+        beforeMaxBlock->next = maxBlock->next;
+      }
+      delete maxBlock;
+    }
+    m_size--;
+    return max;
+  }
+
+  // Reverse the container: reverse the block chain and each block in place
+  void reverse() {
+    Block<T, N> *prev = nullptr;
+    Block<T, N> *curr = m_head;
+    while (curr != nullptr) {
+      Block<T, N> *next = curr->next;
+      std::reverse(curr->begin(), curr->end());
+      curr->next = prev;
+      prev = curr;
+      curr = next;
+    }
+    m_head = prev;
+  }
+
+  // Returns a std::string equivalent of the container
+  std::string to_string() const {
+    std::string answer = "{";
+    bool first = true;
+    for (const Block<T, N> *block = m_head; block != nullptr; block = block->next) {
+      for (const T *it = block->begin(); it != block->end(); ++it) {
+        if (!first) {
+          answer += ", ";
+        }
+        answer += element_to_string(*it);
+        first = false;
+      }
+    }
+    answer += "}";
+    return answer;
+  }
+};
+
+#endif
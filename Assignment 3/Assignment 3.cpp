@@ -2,8 +2,27 @@
 //
 
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
 #include "BST.hpp"
+#include "ConcurrentTree.hpp"
+#include "PooledTree.hpp"
 
+void insert_benchmark();
+void bulk_load_benchmark();
+void sliding_window_benchmark();
+void order_statistics_benchmark();
+void range_scan_benchmark();
+void frozen_lookup_benchmark();
+void pooled_tree_benchmark();
+void concurrent_read_benchmark();
+void multiset_benchmark();
 
 int main()
 {
@@ -14,4 +33,500 @@ int main()
     tree.insert(0);
     tree.insert(3);
     std::cout << tree.to_string() << std::endl;
+
+    insert_benchmark();
+    bulk_load_benchmark();
+    sliding_window_benchmark();
+    order_statistics_benchmark();
+    range_scan_benchmark();
+    frozen_lookup_benchmark();
+    pooled_tree_benchmark();
+    concurrent_read_benchmark();
+    multiset_benchmark();
+}
+
+// Insert throughput from 1e3 to 1e7 keys, in ascending order (the case that
+// degenerates a plain BST) and in a scrambled order
+void insert_benchmark()
+{
+    std::cout << "insert_benchmark()" << std::endl;
+    typedef std::chrono::steady_clock Clock;
+
+    for (int count = 1000; count <= 10000000; count *= 10) {
+        Clock::time_point start = Clock::now();
+        {
+            Tree<int> tree;
+            for (int i = 0; i < count; i++) {
+                tree.insert(i);
+            }
+            std::cout << count << " ascending keys: height " << tree.height();
+        }
+        double ascendingMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        start = Clock::now();
+        {
+            Tree<int> tree;
+            for (int i = 0; i < count; i++) {
+                tree.insert(static_cast<int>((i * 2654435761ull) % count)); // a permutation, the factor is prime
+            }
+            std::cout << ", scrambled keys: height " << tree.height();
+        }
+        double scrambledMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::cout << "; " << count / ascendingMs / 1000 << " / " << count / scrambledMs / 1000
+            << " M inserts/s (including teardown)" << std::endl;
+    }
+}
+
+// Startup rebuild of 10M keys: insert one by one against from_sorted, then
+// merging a batch of 2M scrambled keys with insert against insert_batch
+void bulk_load_benchmark()
+{
+    std::cout << "bulk_load_benchmark()" << std::endl;
+    const int COUNT = 10000000;
+    const int BATCH = 2000000;
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<int> keys(COUNT);
+    for (int i = 0; i < COUNT; i++) {
+        keys[i] = 2 * i; // even keys, so the batch below can add odd ones
+    }
+    std::vector<int> batch(BATCH);
+    for (int i = 0; i < BATCH; i++) {
+        batch[i] = static_cast<int>((i * 2654435761ull) % (2 * COUNT));
+    }
+
+    Clock::time_point start = Clock::now();
+    double insertBatchMs = 0;
+    {
+        Tree<int> tree;
+        for (int key : keys) {
+            tree.insert(key);
+        }
+        double insertMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        start = Clock::now();
+        for (int key : batch) {
+            tree.insert(key);
+        }
+        insertBatchMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        std::cout << COUNT << " inserts:      " << insertMs << " ms, height " << tree.height() << std::endl;
+    }
+
+    start = Clock::now();
+    Tree<int> tree = Tree<int>::from_sorted(keys.begin(), keys.end());
+    double fromSortedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::cout << "from_sorted " << COUNT << ": " << fromSortedMs << " ms, height " << tree.height() << std::endl;
+
+    start = Clock::now();
+    tree.insert_batch(batch.begin(), batch.end());
+    double batchMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::cout << BATCH << " more by insert: " << insertBatchMs << " ms; by insert_batch: " << batchMs
+        << " ms, " << tree.size() << " keys, height " << tree.height() << std::endl;
+}
+
+// Sliding-window dedup: a window of 100k keys slides 1k keys at a time.
+// Keeping one tree with insert/erase against rebuilding it every window.
+void sliding_window_benchmark()
+{
+    std::cout << "sliding_window_benchmark()" << std::endl;
+    const int WINDOW = 100000;
+    const int SLIDE = 1000;
+    const int STEPS = 200;
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<int> stream(WINDOW + SLIDE * STEPS);
+    for (size_t i = 0; i < stream.size(); i++) {
+        stream[i] = static_cast<int>((i * 2654435761ull) % 2147483647);
+    }
+
+    Clock::time_point start = Clock::now();
+    size_t rebuiltSize = 0;
+    for (int step = 0; step <= STEPS; step++) {
+        Tree<int> tree;
+        for (int i = step * SLIDE; i < step * SLIDE + WINDOW; i++) {
+            tree.insert(stream[i]);
+        }
+        rebuiltSize = tree.size();
+    }
+    double rebuildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    Tree<int> tree;
+    for (int i = 0; i < WINDOW; i++) {
+        tree.insert(stream[i]);
+    }
+    for (int step = 1; step <= STEPS; step++) {
+        for (int i = (step - 1) * SLIDE; i < step * SLIDE; i++) {
+            tree.erase(stream[i]);
+            tree.insert(stream[i + WINDOW]);
+        }
+    }
+    double slideMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    std::cout << STEPS << " slides of " << SLIDE << " over a " << WINDOW << " window: rebuild " << rebuildMs
+        << " ms, insert/erase " << slideMs << " ms (size " << rebuiltSize << " / " << tree.size()
+        << ", height " << tree.height() << ")" << std::endl;
+}
+
+// p50/p90/p99 and a range count: parsing in_order() against select and
+// count_range, then select alone on a 1M-key tree
+void order_statistics_benchmark()
+{
+    std::cout << "order_statistics_benchmark()" << std::endl;
+    const int COUNT = 20000;
+    const int BIG_COUNT = 1000000;
+    const int REPORTS = 20;
+    const int QUERIES = 1000000;
+    typedef std::chrono::steady_clock Clock;
+
+    Tree<int> tree;
+    for (int i = 0; i < COUNT; i++) {
+        tree.insert(static_cast<int>((i * 2654435761ull) % COUNT) * 3);
+    }
+
+    Clock::time_point start = Clock::now();
+    long long parsed = 0;
+    for (int report = 0; report < REPORTS; report++) {
+        std::vector<int> sorted;
+        std::istringstream in(tree.in_order());
+        int value;
+        while (in >> value) {
+            sorted.push_back(value);
+        }
+        size_t inRange = 0;
+        for (int element : sorted) {
+            inRange += element >= 3000 && element <= 6000;
+        }
+        parsed += sorted[sorted.size() / 2] + sorted[sorted.size() * 9 / 10] + sorted[sorted.size() * 99 / 100] + inRange;
+    }
+    double parseMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / REPORTS;
+
+    start = Clock::now();
+    long long selected = 0;
+    for (int report = 0; report < REPORTS; report++) {
+        selected += tree.select(tree.size() / 2) + tree.select(tree.size() * 9 / 10) + tree.select(tree.size() * 99 / 100)
+            + tree.count_range(3000, 6000);
+    }
+    double selectUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / REPORTS;
+
+    std::cout << COUNT << " keys, one report: in_order() parse " << parseMs << " ms, select/count_range "
+        << selectUs << " us (same: " << (parsed == selected) << ")" << std::endl;
+
+    Tree<int> big;
+    for (int i = 0; i < BIG_COUNT; i++) {
+        big.insert(i);
+    }
+    start = Clock::now();
+    long long checksum = 0;
+    for (int i = 0; i < QUERIES; i++) {
+        checksum += big.select((i * 7919ull) % BIG_COUNT) - big.rank(static_cast<int>((i * 7919ull) % BIG_COUNT));
+    }
+    double queryNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / QUERIES;
+    std::cout << BIG_COUNT << " keys: select + rank " << queryNs << " ns (checksum 0: " << (checksum == 0) << ")" << std::endl;
+}
+
+// Time-window queries over 1M timestamps: range(lo, hi) against filtering a
+// full in-order walk, and against parsing in_order() on a 20k-key tree
+void range_scan_benchmark()
+{
+    std::cout << "range_scan_benchmark()" << std::endl;
+    const int COUNT = 1000000;
+    const int SMALL_COUNT = 20000;
+    const int WIDTH = 1000;
+    const int QUERIES = 1000;
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<int> stamps(COUNT);
+    for (int i = 0; i < COUNT; i++) {
+        stamps[i] = 10 * i;
+    }
+    Tree<int> tree = Tree<int>::from_sorted(stamps.begin(), stamps.end());
+
+    Clock::time_point start = Clock::now();
+    long long ranged = 0;
+    for (int q = 0; q < QUERIES; q++) {
+        int lo = static_cast<int>((q * 7919ull) % COUNT) * 10;
+        for (int stamp : tree.range(lo, lo + 10 * WIDTH)) {
+            ranged += stamp;
+        }
+    }
+    double rangeUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / QUERIES;
+
+    const int WALKS = 10;
+    start = Clock::now();
+    long long walked = 0;
+    for (int q = 0; q < WALKS; q++) {
+        int lo = static_cast<int>((q * 7919ull) % COUNT) * 10;
+        for (int stamp : tree) {
+            if (stamp >= lo && stamp <= lo + 10 * WIDTH) walked += stamp;
+        }
+    }
+    double walkUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / WALKS;
+
+    Tree<int> small = Tree<int>::from_sorted(stamps.begin(), stamps.begin() + SMALL_COUNT);
+    start = Clock::now();
+    long long parsed = 0;
+    {
+        std::istringstream in(small.in_order());
+        int stamp;
+        while (in >> stamp) {
+            if (stamp >= 0 && stamp <= 10 * WIDTH) parsed += stamp;
+        }
+    }
+    double parseUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+    std::cout << COUNT << " keys, windows of " << WIDTH + 1 << ": range " << rangeUs << " us, full walk "
+        << walkUs << " us; " << SMALL_COUNT << " keys, in_order() parse " << parseUs << " us (checksum " << ranged + walked + parsed << ")" << std::endl;
+}
+
+// Random contains/successor lookups on the pointer tree against its frozen
+// Eytzinger snapshot. 1e8 keys needs about 5 GB for the pointer tree, so the
+// default stops at 1e7; raise MAX_KEYS on a machine that has the memory.
+void frozen_lookup_benchmark()
+{
+    std::cout << "frozen_lookup_benchmark()" << std::endl;
+    const int MAX_KEYS = 10000000;
+    const int LOOKUPS = 2000000;
+    typedef std::chrono::steady_clock Clock;
+
+    for (int count = 1000000; count <= MAX_KEYS; count *= 10) {
+        double treeMops = 0;
+        double frozenMops = 0;
+        long long treeFound = 0;
+        long long frozenFound = 0;
+        FrozenTree<int> frozen = Tree<int>().freeze();
+        {
+            std::vector<int> keys(count);
+            for (int i = 0; i < count; i++) {
+                keys[i] = 2 * i; // odd lookups miss
+            }
+            Tree<int> tree = Tree<int>::from_sorted(keys.begin(), keys.end());
+            keys = std::vector<int>();
+
+            Clock::time_point start = Clock::now();
+            for (int i = 0; i < LOOKUPS; i++) {
+                int key = static_cast<int>((i * 2654435761ull) % (2ull * count - 2)); // below the largest key, so there is always a successor
+                treeFound += tree.contains(key);
+                treeFound += tree.successor(key);
+            }
+            treeMops = LOOKUPS / std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+            frozen = tree.freeze();
+        } // the pointer tree is freed here
+
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < LOOKUPS; i++) {
+            int key = static_cast<int>((i * 2654435761ull) % (2ull * count - 2));
+            frozenFound += frozen.contains(key);
+            frozenFound += frozen.successor(key);
+        }
+        frozenMops = LOOKUPS / std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+        std::cout << count << " keys: Tree " << treeMops << " M lookups/s, FrozenTree " << frozenMops
+            << " M lookups/s (same: " << (treeFound == frozenFound) << ")" << std::endl;
+    }
+}
+
+// Tree<int> against PooledTree<int> on scrambled keys: bytes per node, insert
+// throughput (including teardown, one free per node against one for the
+// arena), the time compact() takes, and lookup throughput on the compacted tree
+void pooled_tree_benchmark()
+{
+    std::cout << "pooled_tree_benchmark()" << std::endl;
+    const int LOOKUPS = 2000000;
+    typedef std::chrono::steady_clock Clock;
+
+    std::cout << "bytes per node: Tree " << sizeof(Node<int>) << " + allocator header, PooledTree "
+        << sizeof(PoolNode<int>) << std::endl;
+    for (int count = 100000; count <= 10000000; count *= 10) {
+        long long treeFound = 0;
+        long long pooledFound = 0;
+
+        Clock::time_point start = Clock::now();
+        double treeLookupMs = 0;
+        {
+            Tree<int> tree;
+            for (int i = 0; i < count; i++) {
+                tree.insert(static_cast<int>((i * 2654435761ull) % count) * 2); // odd lookups miss
+            }
+            Clock::time_point lookupStart = Clock::now();
+            for (int i = 0; i < LOOKUPS; i++) {
+                treeFound += tree.contains(static_cast<int>((i * 40503ull) % (2ull * count)));
+            }
+            treeLookupMs = std::chrono::duration<double, std::milli>(Clock::now() - lookupStart).count();
+        }
+        double treeInsertMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() - treeLookupMs;
+
+        start = Clock::now();
+        double pooledLookupMs = 0;
+        double compactMs = 0;
+        size_t pooledBytes = 0;
+        size_t compactBytes = 0;
+        {
+            PooledTree<int> tree;
+            for (int i = 0; i < count; i++) {
+                tree.insert(static_cast<int>((i * 2654435761ull) % count) * 2);
+            }
+            pooledBytes = tree.memory_bytes();
+            Clock::time_point compactStart = Clock::now();
+            tree.compact(); // van Emde Boas order for the lookups below
+            compactMs = std::chrono::duration<double, std::milli>(Clock::now() - compactStart).count();
+            compactBytes = tree.memory_bytes();
+            Clock::time_point lookupStart = Clock::now();
+            for (int i = 0; i < LOOKUPS; i++) {
+                pooledFound += tree.contains(static_cast<int>((i * 40503ull) % (2ull * count)));
+            }
+            pooledLookupMs = std::chrono::duration<double, std::milli>(Clock::now() - lookupStart).count();
+        }
+        double pooledInsertMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() - pooledLookupMs - compactMs;
+
+        std::cout << count << " keys: arena " << double(pooledBytes) / count << " B/node, "
+            << double(compactBytes) / count << " after compact() (" << compactMs << " ms); Tree "
+            << count / treeInsertMs / 1000 << " M inserts/s, " << LOOKUPS / treeLookupMs / 1000
+            << " M lookups/s; PooledTree " << count / pooledInsertMs / 1000 << " M inserts/s, "
+            << LOOKUPS / pooledLookupMs / 1000 << " M lookups/s (same: " << (treeFound == pooledFound) << ")" << std::endl;
+    }
+}
+
+// Readers doing contains and successor while one writer keeps inserting, on
+// 1 to N reader threads: ConcurrentTree snapshots against a Tree<int> behind
+// a global mutex. Readers each do a fixed number of lookups; the writer
+// inserts until they are done.
+void concurrent_read_benchmark()
+{
+    std::cout << "concurrent_read_benchmark()" << std::endl;
+    const int PREFILL = 1000000;
+    const int LOOKUPS_PER_READER = 250000;
+    typedef std::chrono::steady_clock Clock;
+
+    ConcurrentTree<int> snapshots;
+    Tree<int> locked;
+    for (int i = 0; i < PREFILL; i++) {
+        int key = static_cast<int>((i * 2654435761ull) % PREFILL) * 2;
+        snapshots.insert(key);
+        locked.insert(key);
+    }
+    std::mutex lock;
+    std::atomic<long long> found{ 0 }; // keeps the lookups from being optimised away
+    int nextKey = 1; // the writer adds odd keys, past the ones already added
+
+    unsigned maxReaders = std::max(4u, std::thread::hardware_concurrency());
+    for (unsigned readerCount = 1; readerCount <= maxReaders; readerCount *= 2) {
+        std::atomic<unsigned> running{ readerCount };
+        long long snapshotInserts = 0;
+        std::vector<std::thread> threads;
+        Clock::time_point start = Clock::now();
+        for (unsigned r = 0; r < readerCount; r++) {
+            threads.emplace_back([&snapshots, &running, &found, r]() {
+                long long readerFound = 0;
+                for (int i = 0; i < LOOKUPS_PER_READER; i++) {
+                    int key = static_cast<int>(((i + r * 7919ull) * 40503ull) % (2ull * PREFILL - 2));
+                    readerFound += snapshots.contains(key);
+                    readerFound += snapshots.successor(key);
+                }
+                found += readerFound;
+                running--;
+            });
+        }
+        while (running.load() > 0) {
+            snapshots.insert(nextKey);
+            nextKey += 2;
+            snapshotInserts++;
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        double snapshotMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        running = readerCount;
+        long long lockedInserts = 0;
+        int lockedKey = nextKey;
+        threads.clear();
+        start = Clock::now();
+        for (unsigned r = 0; r < readerCount; r++) {
+            threads.emplace_back([&locked, &lock, &running, &found, r]() {
+                long long readerFound = 0;
+                for (int i = 0; i < LOOKUPS_PER_READER; i++) {
+                    int key = static_cast<int>(((i + r * 7919ull) * 40503ull) % (2ull * PREFILL - 2));
+                    std::lock_guard<std::mutex> guard(lock);
+                    readerFound += locked.contains(key);
+                    readerFound += locked.successor(key);
+                }
+                found += readerFound;
+                running--;
+            });
+        }
+        while (running.load() > 0) {
+            std::lock_guard<std::mutex> guard(lock);
+            locked.insert(lockedKey);
+            lockedKey += 2;
+            lockedInserts++;
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        double lockedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        const double lookups = 1.0 * LOOKUPS_PER_READER * readerCount;
+        std::cout << readerCount << " readers: snapshots " << lookups / snapshotMs / 1000 << " M lookups/s, "
+            << snapshotInserts / snapshotMs << " K inserts/s; mutex " << lookups / lockedMs / 1000
+            << " M lookups/s, " << lockedInserts / lockedMs << " K inserts/s" << std::endl;
+    }
+}
+
+// Heavily skewed event keys (most events land on a few keys) kept as a
+// multiset Tree<int>, one counted node per distinct key, against
+// std::multiset<int>, one node per event: nodes, insert throughput, and
+// count_range against std::distance over the same range
+void multiset_benchmark()
+{
+    std::cout << "multiset_benchmark()" << std::endl;
+    const int DISTINCT = 100000;
+    const int QUERIES = 20; // std::distance walks every event in the range
+    typedef std::chrono::steady_clock Clock;
+
+    for (int events = 100000; events <= 1000000; events *= 10) {
+        std::vector<int> keys(events);
+        for (int i = 0; i < events; i++) {
+            double u = ((i * 2654435761ull) % 1048576) / 1048576.0;
+            keys[i] = static_cast<int>(DISTINCT * u * u * u); // cubed, so low keys dominate
+        }
+
+        Clock::time_point start = Clock::now();
+        Tree<int> tree(true);
+        for (int key : keys) {
+            tree.insert(key);
+        }
+        double treeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        start = Clock::now();
+        std::multiset<int> reference(keys.begin(), keys.end());
+        double referenceMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        size_t nodes = 0;
+        for (Tree<int>::const_iterator it = tree.begin(); it != tree.end(); it = tree.upper_bound(*it)) {
+            nodes++;
+        }
+
+        long long treeCounted = 0;
+        long long referenceCounted = 0;
+        start = Clock::now();
+        for (int q = 0; q < QUERIES; q++) {
+            int lo = static_cast<int>((q * 40503ull) % (DISTINCT / 100));
+            treeCounted += tree.count_range(lo, lo + DISTINCT / 100);
+        }
+        double treeQueryMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        start = Clock::now();
+        for (int q = 0; q < QUERIES; q++) {
+            int lo = static_cast<int>((q * 40503ull) % (DISTINCT / 100));
+            referenceCounted += std::distance(reference.lower_bound(lo), reference.upper_bound(lo + DISTINCT / 100));
+        }
+        double referenceQueryMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        std::cout << events << " events: Tree " << nodes << " nodes, " << events / treeMs / 1000
+            << " M inserts/s, " << QUERIES / treeQueryMs << " K count_range/s; std::multiset "
+            << reference.size() << " nodes, " << events / referenceMs / 1000 << " M inserts/s, "
+            << QUERIES / referenceQueryMs << " K counts/s (size " << (tree.size() == reference.size())
+            << ", same: " << (treeCounted == referenceCounted) << ")" << std::endl;
+    }
 }
@@ -4,8 +4,19 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <functional>
+#include <iterator>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define TREE_PREFETCH
+#endif
 
 using std::string;
 
@@ -22,24 +33,230 @@ std::string my_to_string(const std::string& t) {
 template <typename T> struct Node {
   T element;
   int height;
+  size_t count; // occurrences of element, above 1 only in a multiset
+  size_t size;  // number of elements in the subtree rooted here, counts included
   Node<T> *left;
   Node<T> *right;
+  Node<T> *parent; // nullptr at the root, lets iterators step without a stack
 
   Node(T element)
-      : element{element}, height{0}, left{nullptr}, right{nullptr} {}
+      : element{element}, height{0}, count{1}, size{1}, left{nullptr}, right{nullptr}, parent{nullptr} {}
   Node(T element, int height)
-      : element{element}, height{height}, left{nullptr}, right{nullptr} {}
+      : element{element}, height{height}, count{1}, size{1}, left{nullptr}, right{nullptr}, parent{nullptr} {}
+};
+
+// Read-only snapshot of a Tree<T> made by Tree<T>::freeze(). The elements
+// sit in one array in Eytzinger (BFS) order: the root at 1, the children of
+// k at 2k and 2k + 1. A search reads one element per level from a single
+// contiguous array, without branching on the comparison, and prefetches the
+// cache line that holds the descendants a few levels down.
+// T must be default constructible.
+template <typename T> class FrozenTree {
+public:
+  // Lays out count elements from an ascending range
+  template <typename It>
+  FrozenTree(It first, size_t count) : m_elements(count + 1) {
+    fill(first, 1);
+  }
+
+  bool empty() const { return m_elements.size() == 1; }
+  size_t size() const { return m_elements.size() - 1; }
+
+  // Checks whether the tree contains the specified element
+  bool contains(T element) const {
+    const T* found = lower_bound(element);
+    return found && !(element < *found);
+  }
+
+  // First element not less than element, nullptr if there is none
+  const T* lower_bound(T element) const {
+    return at(search(element, false));
+  }
+
+  // Returns the successor of the specified element
+  T successor(T element) const {
+    const T* found = at(search(element, true));
+    if (!found) {
+      throw std::out_of_range("There is no successor");
+    }
+    return *found;
+  }
+
+  // Returns the minimum element
+  T min() const {
+    if (empty()) {
+      throw std::out_of_range("Tree is empty");
+    }
+    size_t k = 1;
+    while (2 * k <= size()) k = 2 * k;
+    return m_elements[k];
+  }
+
+  // Returns the maximum element
+  T max() const {
+    if (empty()) {
+      throw std::out_of_range("Tree is empty");
+    }
+    size_t k = 1;
+    while (2 * k + 1 <= size()) k = 2 * k + 1;
+    return m_elements[k];
+  }
+
+private:
+  std::vector<T> m_elements; // m_elements[0] is unused
+
+  // Elements per 64-byte cache line. The PER_LINE descendants log2(PER_LINE)
+  // levels below k sit next to each other from PER_LINE * k on.
+  static const size_t PER_LINE = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+  // In-order over the implicit tree, so the range lands in BFS positions
+  template <typename It>
+  void fill(It& next, size_t k) {
+    if (k >= m_elements.size()) return;
+    fill(next, 2 * k);
+    m_elements[k] = *next;
+    ++next;
+    fill(next, 2 * k + 1);
+  }
+
+  // Descends to a leaf going right past every element less than element (or
+  // not greater, for a strict search). The answer is the last node where the
+  // search went left: drop the trailing right turns and that left turn.
+  size_t search(const T& element, bool strict) const {
+    size_t n = size();
+    size_t k = 1;
+    while (k <= n) {
+#ifdef TREE_PREFETCH
+      if (PER_LINE * k <= n) {
+        _mm_prefetch(reinterpret_cast<const char*>(&m_elements[PER_LINE * k]), _MM_HINT_T0);
+      }
+#endif
+      const T& current = m_elements[k];
+      k = 2 * k + (strict ? !(element < current) : current < element);
+    }
+    while (k & 1) k >>= 1;
+    return k >> 1;
+  }
+
+  const T* at(size_t k) const {
+    return k == 0 ? nullptr : &m_elements[k];
+  }
 };
 
+// AVL tree. By default it is a set and inserting an element it holds does
+// nothing; a multiset keeps one node per distinct element with a count of
+// its occurrences, and everything that counts or visits elements (size,
+// rank, select, the traversals and iterators) sees each occurrence.
 template <typename T> class Tree {
 private:
   size_t m_size;
   Node<T> *m_root;
+  bool m_multiset;
 
 public:
-  // Constructor
+  // Bidirectional in-order iterator. Elements are read-only since changing
+  // one would break the ordering. Steps follow parent pointers, so an
+  // iterator never allocates and a full pass is O(n). In a multiset it
+  // visits an element once per occurrence.
+  class const_iterator {
+  public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    const_iterator() : m_node{nullptr}, m_tree{nullptr}, m_occurrence{0} {}
+    const_iterator(const Node<T>* node, const Tree<T>* tree) : m_node{node}, m_tree{tree}, m_occurrence{0} {}
+
+    reference operator*() const { return m_node->element; }
+    pointer operator->() const { return &m_node->element; }
+
+    const_iterator& operator++() {
+      if (++m_occurrence < m_node->count) {
+        return *this;
+      }
+      m_occurrence = 0;
+      if (m_node->right) {
+        m_node = leftmost(m_node->right);
+      }
+      else {
+        // climb until we come up from a left child
+        const Node<T>* child = m_node;
+        m_node = m_node->parent;
+        while (m_node && child == m_node->right) {
+          child = m_node;
+          m_node = m_node->parent;
+        }
+      }
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    // Decrementing end() gives the maximum
+    const_iterator& operator--() {
+      if (m_occurrence > 0) {
+        m_occurrence--;
+        return *this;
+      }
+      if (!m_node) {
+        m_node = rightmost(m_tree->m_root);
+      }
+      else if (m_node->left) {
+        m_node = rightmost(m_node->left);
+      }
+      else {
+        const Node<T>* child = m_node;
+        m_node = m_node->parent;
+        while (m_node && child == m_node->left) {
+          child = m_node;
+          m_node = m_node->parent;
+        }
+      }
+      if (m_node) m_occurrence = m_node->count - 1; // the last occurrence
+      return *this;
+    }
+    const_iterator operator--(int) {
+      const_iterator old = *this;
+      --*this;
+      return old;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return m_node == other.m_node && m_occurrence == other.m_occurrence;
+    }
+    bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+  private:
+    const Node<T>* m_node; // nullptr at end()
+    const Tree<T>* m_tree;
+    size_t m_occurrence;   // which of m_node's occurrences, 0 at end()
+  };
+  typedef const_iterator iterator;
+
+  // A pair of iterators usable in a range-based for
+  class Range {
+  public:
+    Range(const_iterator first, const_iterator last) : m_first{first}, m_last{last} {}
+    const_iterator begin() const { return m_first; }
+    const_iterator end() const { return m_last; }
+    bool empty() const { return m_first == m_last; }
+
+  private:
+    const_iterator m_first;
+    const_iterator m_last;
+  };
+
+  // Constructor, an empty set
   Tree();
 
+  // Constructs an empty multiset, or set if multiset is false
+  explicit Tree(bool multiset);
+
   // Rule of three:
   // If a class requires a user-defined destructor, a user-defined copy
   // constructor, or a user-defined copy assignment operator, it almost
@@ -48,24 +265,61 @@ public:
   // Destructor
   ~Tree();
 
+  // Copy constructor, copies the shape and heights node for node
+  Tree(const Tree<T>& other);
+
+  // Copy assignment
+  Tree<T>& operator=(const Tree<T>& other);
+
+  // Move constructor and assignment, take over other's nodes
+  Tree(Tree<T>&& other) noexcept;
+  Tree<T>& operator=(Tree<T>&& other) noexcept;
+
+  // Builds a perfectly balanced tree from an ascending range in O(n).
+  // Repeated elements are kept once, or counted in a multiset; throws if
+  // the range is not sorted.
+  template <typename It>
+  static Tree<T> from_sorted(It first, It last, bool multiset = false);
+
   // Returns a pointer to the root
   Node<T> *root();
 
   // Checks whether the tree is empty
   bool empty() const;
 
-  // Returns the number of elements
+  // Returns the number of elements, every occurrence counted
   size_t size() const;
 
+  // Checks whether the tree keeps repeated elements
+  bool is_multiset() const { return m_multiset; }
+
   // Returns the height of the tree
   int height() const;
 
-  // Inserts the specified element
+  // Inserts the specified element. A set ignores an element it already
+  // holds, a multiset counts one more occurrence.
   void insert(T element);
 
+  // Inserts every element of a range. Small batches go in one by one; a
+  // batch that is large next to the tree is sorted and merged with the
+  // tree's in-order nodes, and the tree is rebuilt balanced in O(n + k log k).
+  template <typename It>
+  void insert_batch(It first, It last);
+
+  // Removes the specified element, rebalancing on the way up in O(log n).
+  // Removes one occurrence in a multiset. Returns false if it wasn't there.
+  bool erase(T element);
+
+  // Removes and returns (one occurrence of) the minimum / maximum element
+  T erase_min();
+  T erase_max();
+
   // Checks whether the container contains the specified element
   bool contains(T element) const;
 
+  // Number of occurrences of the specified element, at most 1 in a set
+  size_t count(T element) const;
+
   // Returns the maximum element
   T max() const;
 
@@ -75,6 +329,30 @@ public:
   // Returns the successor of the specified element
   T successor(T element);
 
+  // In-order iterators, smallest element first
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  // First element not less than / greater than element, O(log n)
+  const_iterator lower_bound(T element) const;
+  const_iterator upper_bound(T element) const;
+
+  // The elements in [lo, hi], O(log n) to find plus O(1) amortised per element
+  Range range(T lo, T hi) const;
+
+  // Read-only snapshot of the current elements in a cache-friendly layout, O(n)
+  FrozenTree<T> freeze() const;
+
+  // Order statistics from the subtree sizes, O(log n) each:
+  // number of elements less than element
+  size_t rank(T element) const;
+
+  // The k-th smallest element, counting from 0
+  T select(size_t k) const;
+
+  // Number of elements in [lo, hi]
+  size_t count_range(T lo, T hi) const;
+
   // Convert each element in the tree to string in pre-order.
   string pre_order();
 
@@ -102,6 +380,9 @@ private:
       res += " ";
     }
     res += my_to_string(node->element);
+    if (node->count > 1) {
+      res += "(n=" + my_to_string(node->count) + ")";
+    }
     if (with_height) {
       res += "(h=" + my_to_string(node->height) + ")";
     }
@@ -114,30 +395,129 @@ private:
 
   // Feel free to declare helper functions here, if necessary
 
+  void swap(Tree<T>& other) noexcept {
+      std::swap(m_root, other.m_root);
+      std::swap(m_size, other.m_size);
+      std::swap(m_multiset, other.m_multiset);
+  }
+
+  // Copies a subtree, heights and counts included
+  static Node<T>* copyNodes(const Node<T>* node) {
+      if (!node) return nullptr;
+      Node<T>* copy = new Node<T>(node->element, node->height);
+      copy->count = node->count;
+      copy->size = node->size;
+      try {
+          copy->left = copyNodes(node->left);
+          if (copy->left) copy->left->parent = copy;
+          copy->right = copyNodes(node->right);
+          if (copy->right) copy->right->parent = copy;
+      }
+      catch (...) {
+          postClear(copy);
+          throw;
+      }
+      return copy;
+  }
+
+  // Links nodes[0, count), already in order, into a perfectly balanced
+  // subtree and sets their heights. Returns its root.
+  static Node<T>* linkBalanced(Node<T>** nodes, size_t count) {
+      if (count == 0) return nullptr;
+      size_t middle = count / 2;
+      Node<T>* current = nodes[middle];
+      current->parent = nullptr; // set by the caller unless this is the root
+      current->left = linkBalanced(nodes, middle);
+      if (current->left) current->left->parent = current;
+      current->right = linkBalanced(nodes + middle + 1, count - middle - 1);
+      if (current->right) current->right->parent = current;
+      current->height = std::max(current->left ? current->left->height : -1,
+                                 current->right ? current->right->height : -1) + 1;
+      current->size = size(current->left) + size(current->right) + current->count;
+      return current;
+  }
+
+  // Smallest / largest node of a subtree
+  static const Node<T>* leftmost(const Node<T>* node) {
+      while (node && node->left) node = node->left;
+      return node;
+  }
+  static const Node<T>* rightmost(const Node<T>* node) {
+      while (node && node->right) node = node->right;
+      return node;
+  }
+
+  // Appends the subtree's nodes to out in order, without recursion
+  static void collectInOrder(Node<T>* node, std::vector<Node<T>*>& out) {
+      std::vector<Node<T>*> stack;
+      while (node || !stack.empty()) {
+          while (node) {
+              stack.push_back(node);
+              node = node->left;
+          }
+          node = stack.back();
+          stack.pop_back();
+          out.push_back(node);
+          node = node->right;
+      }
+  }
+
   // Use post-order-traversal to delete children first then node itself.
-  void postClear(Node<T>* node) {
+  static void postClear(Node<T>* node) {
       if (!node) return;
       postClear(node->left);
       postClear(node->right);
       delete node;
   }
 
-  // Calculate height at a given node
+  // Longest root-to-leaf path insertAVL can meet: an AVL tree of 2^64 nodes is under 93 high
+  static const int MAX_HEIGHT = 96;
+
+  // Height at a given node, as cached in the node
   int height(Node<T>* node) const {
       if (!node) return -1; // height of empty subtree, handles empty left/right child
-      int leftHeight = height(node->left);
-      int rightHeight = height(node->right);
-      return std::max(leftHeight, rightHeight) + 1;
+      return node->height;
+  }
+
+  // Subtree size at a given node, counts included, 0 for an empty subtree
+  static size_t size(const Node<T>* node) {
+      return node ? node->size : 0;
+  }
+
+  // Recomputes a node's height and subtree size from its children's
+  static void updateNode(Node<T>* node) {
+      node->height = std::max(node->left ? node->left->height : -1,
+                              node->right ? node->right->height : -1) + 1;
+      node->size = size(node->left) + size(node->right) + node->count;
+  }
+
+  // Number of elements less than element, or not greater when orEqual is set
+  size_t countBelow(const T& element, bool orEqual) const {
+      size_t count = 0;
+      Node<T>* current = m_root;
+      while (current) {
+          if (current->element < element || (orEqual && !(element < current->element))) {
+              count += size(current->left) + current->count;
+              current = current->right;
+          }
+          else {
+              current = current->left;
+          }
+      }
+      return count;
   }
 
   // Helper to perform right-rotate on current node with left child, and update height
   Node<T>* rightRotate(Node<T>* current) {
       Node<T>* child = current->left; // temp pointer
       current->left = child->right; // as current becomes child, it must inherit the child's right subtree
+      if (current->left) current->left->parent = current;
       child->right = current; // current is now the right child of new current
+      child->parent = current->parent;
+      current->parent = child;
 
-      current->height = std::max(height(current->left), height(current->right)) + 1;
-      child->height = std::max(height(child->left), height(child->right)) + 1;
+      updateNode(current);
+      updateNode(child);
 
       return child; // Return the new root to update the parent's pointer
   }
@@ -146,63 +526,36 @@ private:
   Node<T>* leftRotate(Node<T>* current) {
       Node<T>* child = current->right; // temp pointer
       current->right = child->left; // as current becomes child, it must inherit the child's right subtree
+      if (current->right) current->right->parent = current;
       child->left = current; // current is now the right child of new current
+      child->parent = current->parent;
+      current->parent = child;
 
-      current->height = std::max(height(current->left), height(current->right)) + 1;
-      child->height = std::max(height(child->left), height(child->right)) + 1;
+      updateNode(current);
+      updateNode(child);
 
       return child; // Return the new root to update the parent's pointer
   }
 
-  // Insert an element and balance to maintain AVL Tree. Updates height too.
-  Node<T>* insertAVL(Node<T>* current, T element) {
-      //standard insert function (with updating parent node for rotation)
-      if (!current) return new Node<T>(element);
-      if (element < current->element) {
-          current->left = insertAVL(current->left, element);
-      }
-      else if (element > current->element) {
-          current->right = insertAVL(current->right, element);
-      }
- 
-      int heightLeftSubtree = height(current->left);
-      int heightRightSubtree = height(current->right);
-
-      //update height of each node
-      current->height = std::max(heightLeftSubtree, heightRightSubtree) + 1;
-      
-      //check for unbalance, rotate accordingly and return the updated root
-      int heightDifference = heightLeftSubtree - heightRightSubtree;
-      
-      // Case 1: Left-Left -> A(curr) is left-heavy, B(left-child) is left heavy 
-      // i.e. element is inserted into left subtree of left child
-      if (heightDifference > 1 && element < current->left->element) {
-          return rightRotate(current); 
-      }
+  // Updates the height of current and rotates it back into AVL balance if its
+  // subtrees differ by 2. Returns the root of the subtree.
+  Node<T>* rebalance(Node<T>* current) {
+      updateNode(current);
+      int heightDifference = height(current->left) - height(current->right);
 
-      // Case 2: Right-Right -> A(curr) is right heavy, B(right-child) is right heavy
-      // i.e. element is inserted into right subtree of right child
-      if (heightDifference < -1 && element > current->right->element) {
-          return leftRotate(current);
-      }
-      
-      // for A left/right heavy and B is balanced, they are handled in Case 1 and 2 alr
-
-      // Case 3: Left-Right -> A(curr) is left heavy, B(left-child) is right heavy
-      // i.e. element is inserted into right subtree of left child
-      if (heightDifference > 1 && element > current->left->element) {
-          // left-rotate(B) first
-          current->left = leftRotate(current->left);
-          // then right-rotate(A)
+      // Left-Left or Left-Right (left child is right heavy, rotate it first)
+      if (heightDifference > 1) {
+          if (height(current->left->left) < height(current->left->right)) {
+              current->left = leftRotate(current->left);
+          }
           return rightRotate(current);
       }
 
-      // Case 4: Right-Left -> A(curr) is right heavy, B(right-child) is left heavy
-      // i.e. element is inserted into left subtree of right child
-      if (heightDifference < -1 && element < current->right->element) {
-          // right-rotate(B) first
-          current->right = rightRotate(current->right);
-          // then left-rotate(A)
+      // Right-Right or Right-Left (right child is left heavy, rotate it first)
+      if (heightDifference < -1) {
+          if (height(current->right->right) < height(current->right->left)) {
+              current->right = rightRotate(current->right);
+          }
           return leftRotate(current);
       }
 
@@ -210,34 +563,119 @@ private:
       return current;
   }
 
-  // Finds a successor of element from the current node
-  Node<T>* findSuccessor(Node<T>* current, T element) {
-      if (!current) return nullptr;
+  // Insert an element and balance to maintain AVL Tree. Updates height too.
+  // Iterative: the links walked through are kept on a stack, then the nodes
+  // are rebalanced bottom-up using their cached heights, O(log n) in total.
+  // An element already there is counted again in a multiset, which changes
+  // no shape. Returns false if nothing was added.
+  bool insertAVL(T element) {
+      Node<T>** path[MAX_HEIGHT + 1];
+      int depth = 0;
+      Node<T>** link = &m_root;
+      while (*link) {
+          path[depth++] = link;
+          if (element < (*link)->element) {
+              link = &(*link)->left;
+          }
+          else if (element > (*link)->element) {
+              link = &(*link)->right;
+          }
+          else if (!m_multiset) {
+              return false; // duplicate, nothing changes
+          }
+          else {
+              (*link)->count++;
+              while (depth > 0) { // the node itself is on the path too
+                  (*path[--depth])->size++;
+              }
+              return true;
+          }
+      }
+      *link = new Node<T>(element);
+      (*link)->parent = depth > 0 ? *path[depth - 1] : nullptr;
 
-      //if current's value > x, this node is a potential successor
-      if (current->element > element) {
-          //search leftsubtree
-          Node<T>* leftSuccessor = findSuccessor(current->left, element);
-          //return leftsuccessor if found, otherwise this node is the successor
-          return leftSuccessor ? leftSuccessor : current;
+      // walk back up; once a subtree's height is unchanged (or it was rotated,
+      // which restores its old height) nothing above it needs rebalancing,
+      // only its size goes up by one
+      while (depth > 0) {
+          Node<T>** parent = path[--depth];
+          int oldHeight = (*parent)->height;
+          *parent = rebalance(*parent);
+          if ((*parent)->height == oldHeight) {
+              break;
+          }
+      }
+      while (depth > 0) {
+          (*path[--depth])->size++;
       }
+      return true;
+  }
 
-      //if current <= x, continue to search the rightsubtree
-      return findSuccessor(current->right, element);
+  // Removes one occurrence of the element at *link, given the links to its
+  // ancestors in path[0, depth): a multiset node counted more than once only
+  // counts one less, otherwise the node goes.
+  void eraseOne(Node<T>** link, Node<T>** path[], int depth) {
+      if ((*link)->count > 1) {
+          (*link)->count--;
+          (*link)->size--;
+          while (depth > 0) {
+              (*path[--depth])->size--;
+          }
+          return;
+      }
+      eraseAt(link, path, depth);
   }
 
-  // Helper to print in-order-traversal
-  string _in_order(Node<T>* node) {
-      return (node->left == nullptr ? "" : _in_order(node->left) + " ")
-          + my_to_string(node->element)
-          + (node->right == nullptr ? "" : " " + _in_order(node->right));
+  // Removes the node at *link, given the links to its ancestors in
+  // path[0, depth), and rebalances them bottom-up. A node with two children
+  // takes its in-order successor's element and count, and that node is
+  // removed instead.
+  void eraseAt(Node<T>** link, Node<T>** path[], int depth) {
+      Node<T>* node = *link;
+      size_t removed = node->count; // from node and every ancestor
+      size_t moved = 0;             // from the nodes between node and its successor
+      int nodeDepth = depth;
+      if (node->left && node->right) {
+          path[depth++] = link;
+          Node<T>** successorLink = &node->right;
+          while ((*successorLink)->left) {
+              path[depth++] = successorLink;
+              successorLink = &(*successorLink)->left;
+          }
+          node->element = std::move((*successorLink)->element);
+          node->count = (*successorLink)->count;
+          moved = node->count;
+          link = successorLink;
+          node = *link;
+      }
+      *link = node->left ? node->left : node->right; // at most one child left
+      if (*link) (*link)->parent = node->parent;
+      delete node;
+
+      // an ancestor whose height comes out unchanged shields everything above
+      // it from rebalancing; their sizes still go down
+      while (depth > 0) {
+          Node<T>** parent = path[--depth];
+          int oldHeight = (*parent)->height;
+          *parent = rebalance(*parent);
+          if ((*parent)->height == oldHeight) {
+              break;
+          }
+      }
+      while (depth > 0) {
+          --depth;
+          (*path[depth])->size -= depth > nodeDepth ? moved : removed;
+      }
   }
 
-  // Helper to print post-order-traversal
-  string _post_order(Node<T>* node) {
-      return (node->left == nullptr ? "" : _post_order(node->left) + " ")
-          + (node->right == nullptr ? "" : _post_order(node->right) + " ")
-          + my_to_string(node->element);
+  // Helper to print post-order-traversal, appends to out
+  void _post_order(Node<T>* node, string& out) {
+      if (node == nullptr) {
+          return;
+      }
+      _post_order(node->left, out);
+      _post_order(node->right, out);
+      _node_to_string(node, out);
   }
 
   };
@@ -247,6 +685,12 @@ template <typename T> Tree<T>::Tree() {
     m_root = nullptr;
   // TODO: Implement this method
     m_size = 0;
+    m_multiset = false;
+}
+
+// Constructs an empty multiset or set
+template <typename T> Tree<T>::Tree(bool multiset) : Tree() {
+    m_multiset = multiset;
 }
 
 // Destructor
@@ -255,6 +699,77 @@ template <typename T> Tree<T>::~Tree() {
     postClear(m_root);
 }
 
+// Copy constructor
+template <typename T> Tree<T>::Tree(const Tree<T>& other) {
+    m_root = copyNodes(other.m_root);
+    m_size = other.m_size;
+    m_multiset = other.m_multiset;
+}
+
+// Copy assignment
+template <typename T> Tree<T>& Tree<T>::operator=(const Tree<T>& other) {
+    if (this == &other) return *this;
+    Tree<T> temp(other);
+    temp.swap(*this);
+    return *this;
+}
+
+// Move constructor
+template <typename T> Tree<T>::Tree(Tree<T>&& other) noexcept {
+    m_root = nullptr;
+    m_size = 0;
+    m_multiset = false;
+    swap(other);
+}
+
+// Move assignment
+template <typename T> Tree<T>& Tree<T>::operator=(Tree<T>&& other) noexcept {
+    if (this == &other) return *this;
+    Tree<T> temp(std::move(other));
+    temp.swap(*this); // old nodes are freed with temp
+    return *this;
+}
+
+// Builds a balanced tree from an ascending range
+template <typename T>
+template <typename It>
+Tree<T> Tree<T>::from_sorted(It first, It last, bool multiset) {
+    Tree<T> tree(multiset);
+    size_t total = 0;
+    std::vector<Node<T>*> nodes;
+    if (std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>::value) {
+        nodes.reserve(std::distance(first, last));
+    }
+    try {
+        for (; first != last; ++first) {
+            if (!nodes.empty() && !(nodes.back()->element < *first)) {
+                if (*first < nodes.back()->element) {
+                    throw std::invalid_argument("Range is not sorted");
+                }
+                if (multiset) {
+                    nodes.back()->count++;
+                    total++;
+                }
+                continue; // repeated element
+            }
+            if (nodes.size() == nodes.capacity()) {
+                nodes.reserve(2 * nodes.size() + 1); // so push_back can't throw with the node in hand
+            }
+            nodes.push_back(new Node<T>(*first));
+            total++;
+        }
+    }
+    catch (...) {
+        for (Node<T>* node : nodes) {
+            delete node;
+        }
+        throw;
+    }
+    tree.m_root = linkBalanced(nodes.data(), nodes.size());
+    tree.m_size = total;
+    return tree;
+}
+
 // Returns a pointer to the root
 template <typename T> Node<T> *Tree<T>::root() {
   // TODO: Implement this method
@@ -276,14 +791,145 @@ template <typename T> size_t Tree<T>::size() const {
 // Returns the height of the tree
 template <typename T> int Tree<T>::height() const {
   // TODO: Implement this method
-    return height(m_root);
+    return height(m_root); // cached in the root, O(1)
 }
 
 // Inserts an element
 template <typename T> void Tree<T>::insert(T element) {
   // TODO: Implement this method
-    m_root = insertAVL(m_root, element); // start inserting from the root
-    m_size += 1;
+    if (insertAVL(element)) { // start inserting from the root
+        m_size += 1;
+    }
+}
+
+// Inserts every element of a range
+template <typename T>
+template <typename It>
+void Tree<T>::insert_batch(It first, It last) {
+    auto equal = [](const T& a, const T& b) { return !(a < b) && !(b < a); };
+    std::vector<T> batch(first, last);
+    std::sort(batch.begin(), batch.end());
+    if (!m_multiset) {
+        batch.erase(std::unique(batch.begin(), batch.end(), equal), batch.end());
+    }
+
+    // k inserts cost about k log n, a rebuild about n + k log k
+    size_t logSize = 1;
+    while ((size_t(1) << logSize) <= m_size) logSize++;
+    if (batch.size() * logSize < m_size) {
+        for (const T& element : batch) {
+            if (insertAVL(element)) m_size++;
+        }
+        return;
+    }
+
+    std::vector<Node<T>*> existing;
+    existing.reserve(m_size);
+    collectInOrder(m_root, existing);
+
+    // merge the tree's nodes with new nodes for the batch elements it lacks;
+    // in a multiset each run of equal elements adds its length to a count
+    std::vector<Node<T>*> merged;
+    std::vector<Node<T>*> added;
+    std::vector<std::pair<Node<T>*, size_t>> recounted; // applied once nothing can throw
+    size_t addedCount = 0;
+    merged.reserve(existing.size() + batch.size());
+    auto next = existing.begin();
+    try {
+        for (size_t i = 0, runEnd; i < batch.size(); i = runEnd) {
+            const T& element = batch[i];
+            for (runEnd = i + 1; runEnd < batch.size() && equal(batch[runEnd], element); runEnd++) {
+            }
+            while (next != existing.end() && (*next)->element < element) {
+                merged.push_back(*next++);
+            }
+            addedCount += runEnd - i;
+            if (next != existing.end() && !(element < (*next)->element)) {
+                if (m_multiset) {
+                    recounted.push_back(std::make_pair(*next, runEnd - i));
+                }
+                else {
+                    addedCount--; // already in the tree
+                }
+                continue;
+            }
+            added.push_back(new Node<T>(element));
+            added.back()->count = runEnd - i;
+            merged.push_back(added.back());
+        }
+    }
+    catch (...) {
+        for (Node<T>* node : added) { // the tree itself is untouched so far
+            delete node;
+        }
+        throw;
+    }
+    merged.insert(merged.end(), next, existing.end());
+    for (const std::pair<Node<T>*, size_t>& entry : recounted) {
+        entry.first->count += entry.second;
+    }
+
+    m_root = linkBalanced(merged.data(), merged.size());
+    m_size += addedCount;
+}
+
+// Removes an element
+template <typename T> bool Tree<T>::erase(T element) {
+    Node<T>** path[MAX_HEIGHT + 1];
+    int depth = 0;
+    Node<T>** link = &m_root;
+    while (*link) {
+        if (element < (*link)->element) {
+            path[depth++] = link;
+            link = &(*link)->left;
+        }
+        else if (element > (*link)->element) {
+            path[depth++] = link;
+            link = &(*link)->right;
+        }
+        else {
+            eraseOne(link, path, depth);
+            m_size -= 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Removes the minimum element
+template <typename T> T Tree<T>::erase_min() {
+    if (empty()) {
+        throw std::out_of_range("Tree is empty");
+    }
+    Node<T>** path[MAX_HEIGHT + 1];
+    int depth = 0;
+    Node<T>** link = &m_root;
+    while ((*link)->left) {
+        path[depth++] = link;
+        link = &(*link)->left;
+    }
+    T min = (*link)->count > 1 ? (*link)->element : std::move((*link)->element);
+    eraseOne(link, path, depth);
+    m_size -= 1;
+    return min;
+}
+
+// Removes the maximum element
+template <typename T> T Tree<T>::erase_max() {
+    if (empty()) {
+        throw std::out_of_range("Tree is empty");
+    }
+    Node<T>** path[MAX_HEIGHT + 1];
+    int depth = 0;
+    Node<T>** link = &m_root;
+    while ((*link)->right) {
+        path[depth++] = link;
+        link = &(*link)->right;
+    }
+    T max = (*link)->count > 1 ? (*link)->element : std::move((*link)->element);
+    eraseOne(link, path, depth);
+    m_size -= 1;
+    return max;
 }
 
 // Checks whether the container contains the specified element
@@ -302,6 +948,23 @@ template <typename T> bool Tree<T>::contains(T element) const {
     return false;
 }
 
+// Number of occurrences of an element
+template <typename T> size_t Tree<T>::count(T element) const {
+    const Node<T>* current = m_root;
+    while (current) {
+        if (element < current->element) {
+            current = current->left;
+        }
+        else if (current->element < element) {
+            current = current->right;
+        }
+        else {
+            return current->count;
+        }
+    }
+    return 0;
+}
+
 // Returns the maximum element
 template <typename T> T Tree<T>::max() const {
   // TODO: Implement this method
@@ -331,44 +994,163 @@ template <typename T> T Tree<T>::min() const {
 // Returns the successor of the specified element
 template <typename T> T Tree<T>::successor(T element) {
   // TODO: Implement this method
-    Node<T>* successorNode = findSuccessor(m_root, element);
-    if (!successorNode) {
+    // one descent, remembering the last node where it went left
+    const Node<T>* found = nullptr;
+    const Node<T>* current = m_root;
+    while (current) {
+        if (element < current->element) {
+            found = current;
+            current = current->left;
+        }
+        else {
+            current = current->right;
+        }
+    }
+    if (!found) {
         throw std::out_of_range("There is no successor");
     }
-    return successorNode->element;
+    return found->element;
+}
+
+// Read-only snapshot
+template <typename T> FrozenTree<T> Tree<T>::freeze() const {
+    return FrozenTree<T>(begin(), size(m_root));
+}
+
+// Iterator at the minimum
+template <typename T> typename Tree<T>::const_iterator Tree<T>::begin() const {
+    return const_iterator(leftmost(m_root), this);
+}
+
+// Iterator past the maximum
+template <typename T> typename Tree<T>::const_iterator Tree<T>::end() const {
+    return const_iterator(nullptr, this);
 }
 
+// First element not less than element
+template <typename T> typename Tree<T>::const_iterator Tree<T>::lower_bound(T element) const {
+    const Node<T>* found = nullptr;
+    const Node<T>* current = m_root;
+    while (current) {
+        if (current->element < element) {
+            current = current->right;
+        }
+        else {
+            found = current; // candidate, look for a smaller one on the left
+            current = current->left;
+        }
+    }
+    return const_iterator(found, this);
+}
+
+// First element greater than element
+template <typename T> typename Tree<T>::const_iterator Tree<T>::upper_bound(T element) const {
+    const Node<T>* found = nullptr;
+    const Node<T>* current = m_root;
+    while (current) {
+        if (element < current->element) {
+            found = current;
+            current = current->left;
+        }
+        else {
+            current = current->right;
+        }
+    }
+    return const_iterator(found, this);
+}
+
+// The elements in [lo, hi]
+template <typename T> typename Tree<T>::Range Tree<T>::range(T lo, T hi) const {
+    if (hi < lo) {
+        return Range(end(), end());
+    }
+    return Range(lower_bound(lo), upper_bound(hi));
+}
+
+// Number of elements less than element
+template <typename T> size_t Tree<T>::rank(T element) const {
+    return countBelow(element, false);
+}
+
+// The k-th smallest element
+template <typename T> T Tree<T>::select(size_t k) const {
+    if (k >= size(m_root)) {
+        throw std::out_of_range("Rank out of range");
+    }
+    Node<T>* current = m_root;
+    for (;;) {
+        size_t leftSize = size(current->left);
+        if (k < leftSize) {
+            current = current->left;
+        }
+        else if (k < leftSize + current->count) {
+            return current->element;
+        }
+        else {
+            k -= leftSize + current->count;
+            current = current->right;
+        }
+    }
+}
+
+// Number of elements in [lo, hi]
+template <typename T> size_t Tree<T>::count_range(T lo, T hi) const {
+    if (hi < lo) {
+        return 0;
+    }
+    return countBelow(hi, true) - countBelow(lo, false);
+}
+
+// Appends the node's element to out, repeated once per occurrence
 template <typename T>
-string _pre_order(Node<T> *node) {
-  return my_to_string(node->element)
-    + (node->left == nullptr ? "" : " " + _pre_order(node->left))
-    + (node->right == nullptr ? "" : " " + _pre_order(node->right));
+void _node_to_string(Node<T> *node, string &out) {
+  for (size_t i = 0; i < node->count; i++) {
+    if (!out.empty()) {
+      out += " ";
+    }
+    out += my_to_string(node->element);
+  }
 }
 
+// The traversals append to one string, so they are linear rather than
+// re-concatenating every subtree
 template <typename T>
-string Tree<T>::pre_order() {
-  if (m_root == nullptr) {
-    return "";
+void _pre_order(Node<T> *node, string &out) {
+  if (node == nullptr) {
+    return;
   }
-  return _pre_order(m_root);
+  _node_to_string(node, out);
+  _pre_order(node->left, out);
+  _pre_order(node->right, out);
+}
+
+template <typename T>
+string Tree<T>::pre_order() {
+  string result;
+  _pre_order(m_root, result);
+  return result;
 }
 
 template <typename T>
 string Tree<T>::in_order() {
   // TODO: Implement this method
-    if (m_root == nullptr) {
-        return "";
+    // appended through the iterators, so linear rather than re-concatenating every subtree
+    string result;
+    for (const T& element : *this) {
+        if (!result.empty()) {
+            result += " ";
+        }
+        result += my_to_string(element);
     }
-    return _in_order(m_root);
+    return result;
 }
 
 template <typename T>
 string Tree<T>::post_order() {
   // TODO: Implement this method
-    if (m_root == nullptr) {
-        return "";
-    }
-    return _post_order(m_root);
+    string result;
+    _post_order(m_root, result);
+    return result;
 }
 
 #endif
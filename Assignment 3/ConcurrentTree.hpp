@@ -0,0 +1,362 @@
+#pragma once
+#ifndef CONCURRENT_TREE_H
+#define CONCURRENT_TREE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+// Node of a ConcurrentTree. Once a node is reachable from a published root
+// it never changes, so a reader can keep walking it after it is replaced.
+template <typename T> struct SnapNode {
+  T element;
+  int height;
+  SnapNode<T> *left;
+  SnapNode<T> *right;
+  SnapNode<T> *retired_next; // chain of replaced nodes waiting to be freed
+
+  SnapNode(const T &element, SnapNode<T> *left, SnapNode<T> *right)
+      : element{element}, height{0}, left{left}, right{right}, retired_next{nullptr} {}
+};
+
+// AVL tree with the insert/contains/successor/min/max API of Tree<T> that
+// readers can query from any number of threads while inserts go on.
+// insert copies the path from the root down to the new leaf, rebalances the
+// copies and publishes the new root with one atomic store, so a reader only
+// ever sees a whole tree: the one published when it loaded the root.
+// Replaced nodes are reclaimed with epochs as in ConcurrentList: a reader
+// announces the global epoch in a slot while it holds a root, and a node
+// replaced in epoch e is only freed once the global epoch reaches e + 2.
+// Inserts are serialised by a mutex that readers never take.
+template <typename T> class ConcurrentTree {
+private:
+  static const size_t SLOTS = 128;              // concurrent readers before threads spin for a slot
+  static const size_t RECLAIM_THRESHOLD = 1024; // replaced nodes between attempts to move the epoch
+  static const int MAX_HEIGHT = 96;             // as in Tree<T>: an AVL tree of 2^64 nodes is under 93 high
+
+  // One reader in flight. state is 0 when free, otherwise (epoch << 1) | 1.
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> state;
+
+    Slot() : state{0} {}
+  };
+
+  // Nodes one insert copied and the copies it made. The replaced nodes are
+  // only retired once the new root is published; if the insert throws
+  // first, the copies are deleted and the published tree is untouched.
+  struct CopiedPath {
+    SnapNode<T> *replaced[MAX_HEIGHT + 1];
+    SnapNode<T> *fresh[MAX_HEIGHT + 2]; // the copies and the new leaf
+    int replacedCount;
+    int freshCount;
+
+    CopiedPath() : replacedCount{0}, freshCount{0} {}
+  };
+
+  std::atomic<SnapNode<T> *> m_root;
+  std::atomic<size_t> m_size;
+  std::atomic<uint64_t> m_epoch;
+  Slot m_slots[SLOTS];
+  std::mutex m_writer;
+  // Replaced nodes by epoch % 3, only touched under m_writer. A list holds
+  // the nodes of a single epoch, m_retired_epoch[i], so it is freed whole.
+  SnapNode<T> *m_retired[3];
+  uint64_t m_retired_epoch[3];
+  size_t m_retired_since_reclaim;
+
+  static int height(const SnapNode<T> *node) { return node == nullptr ? -1 : node->height; }
+
+  static void updateHeight(SnapNode<T> *node) {
+    int left = height(node->left);
+    int right = height(node->right);
+    node->height = 1 + (left > right ? left : right);
+  }
+
+  // Takes a free slot announcing the current epoch
+  Slot *enter() {
+    size_t index = std::hash<std::thread::id>()(std::this_thread::get_id()) % SLOTS;
+    for (;;) {
+      uint64_t expected = 0;
+      uint64_t announced = (m_epoch.load() << 1) | 1;
+      if (m_slots[index].state.compare_exchange_strong(expected, announced)) {
+        return &m_slots[index];
+      }
+      index = (index + 1) % SLOTS;
+    }
+  }
+
+  // Moves the global epoch forward if every reader in flight has seen it
+  void try_advance_epoch() {
+    uint64_t epoch = m_epoch.load();
+    for (size_t i = 0; i < SLOTS; i++) {
+      uint64_t state = m_slots[i].state.load();
+      if ((state & 1) != 0 && (state >> 1) != epoch) {
+        return;
+      }
+    }
+    m_epoch.compare_exchange_strong(epoch, epoch + 1);
+  }
+
+  static void freeRetired(SnapNode<T> *node) {
+    while (node != nullptr) {
+      SnapNode<T> *next = node->retired_next;
+      delete node;
+      node = next;
+    }
+  }
+
+  // Queues a replaced node once the root that no longer reaches it is
+  // published; needs m_writer. A list that still holds an older epoch with
+  // the same residue was replaced at least three epochs ago and is freed first.
+  void retire(SnapNode<T> *node) {
+    uint64_t epoch = m_epoch.load();
+    size_t list = epoch % 3;
+    if (m_retired_epoch[list] != epoch) {
+      freeRetired(m_retired[list]);
+      m_retired[list] = nullptr;
+      m_retired_epoch[list] = epoch;
+    }
+    node->retired_next = m_retired[list];
+    m_retired[list] = node;
+    m_retired_since_reclaim++;
+  }
+
+  // Every RECLAIM_THRESHOLD replaced nodes, tries to move the epoch forward
+  // and frees the lists no reader can still reach; needs m_writer. O(SLOTS)
+  // per attempt whether or not a reader holds the epoch back.
+  void reclaim() {
+    if (m_retired_since_reclaim < RECLAIM_THRESHOLD) {
+      return;
+    }
+    m_retired_since_reclaim = 0;
+    try_advance_epoch();
+    uint64_t epoch = m_epoch.load();
+    for (size_t list = 0; list < 3; list++) {
+      if (m_retired_epoch[list] + 2 <= epoch) {
+        freeRetired(m_retired[list]);
+        m_retired[list] = nullptr;
+      }
+    }
+  }
+
+  // Rotations of unpublished copies. On an insert path the heavy child (and
+  // for a double rotation the grandchild) is on the path too, so it is a
+  // fresh copy as well and can be relinked in place.
+  static SnapNode<T> *rightRotate(SnapNode<T> *current) {
+    SnapNode<T> *child = current->left;
+    current->left = child->right;
+    child->right = current;
+    updateHeight(current);
+    updateHeight(child);
+    return child;
+  }
+
+  static SnapNode<T> *leftRotate(SnapNode<T> *current) {
+    SnapNode<T> *child = current->right;
+    current->right = child->left;
+    child->left = current;
+    updateHeight(current);
+    updateHeight(child);
+    return child;
+  }
+
+  static SnapNode<T> *rebalance(SnapNode<T> *current) {
+    updateHeight(current);
+    int balance = height(current->left) - height(current->right);
+    if (balance > 1) {
+      if (height(current->left->left) < height(current->left->right)) {
+        current->left = leftRotate(current->left);
+      }
+      return rightRotate(current);
+    }
+    if (balance < -1) {
+      if (height(current->right->right) < height(current->right->left)) {
+        current->right = rightRotate(current->right);
+      }
+      return leftRotate(current);
+    }
+    return current;
+  }
+
+  // Returns a new subtree holding element as well, made of copies of the
+  // nodes on the path and the untouched subtrees of node, or node itself if
+  // element is already there. Every node copied and every copy is recorded
+  // in path.
+  static SnapNode<T> *insertCopy(SnapNode<T> *node, const T &element, CopiedPath &path) {
+    if (node == nullptr) {
+      SnapNode<T> *leaf = new SnapNode<T>(element, nullptr, nullptr);
+      path.fresh[path.freshCount++] = leaf;
+      return leaf;
+    }
+    SnapNode<T> *copy;
+    if (element < node->element) {
+      SnapNode<T> *left = insertCopy(node->left, element, path);
+      if (left == node->left) return node;
+      copy = new SnapNode<T>(node->element, left, node->right);
+    }
+    else if (node->element < element) {
+      SnapNode<T> *right = insertCopy(node->right, element, path);
+      if (right == node->right) return node;
+      copy = new SnapNode<T>(node->element, node->left, right);
+    }
+    else {
+      return node;
+    }
+    path.fresh[path.freshCount++] = copy;
+    path.replaced[path.replacedCount++] = node;
+    return rebalance(copy);
+  }
+
+  static void postClear(SnapNode<T> *node) {
+    if (node == nullptr) return;
+    postClear(node->left);
+    postClear(node->right);
+    delete node;
+  }
+
+public:
+  // Consistent view of the tree as it was when the snapshot was taken.
+  // Nodes it can reach are not freed until it is destroyed, so keep it short.
+  class Snapshot {
+  public:
+    Snapshot(ConcurrentTree<T> &tree) : m_slot{tree.enter()}, m_root{tree.m_root.load()} {}
+
+    ~Snapshot() {
+      if (m_slot != nullptr) m_slot->state.store(0);
+    }
+
+    Snapshot(Snapshot &&other) noexcept : m_slot{other.m_slot}, m_root{other.m_root} {
+      other.m_slot = nullptr;
+    }
+
+    Snapshot(const Snapshot &) = delete;
+    Snapshot &operator=(const Snapshot &) = delete;
+    Snapshot &operator=(Snapshot &&) = delete;
+
+    // Checks whether the snapshot contains the specified element
+    bool contains(const T &element) const {
+      const SnapNode<T> *current = m_root;
+      while (current != nullptr) {
+        if (element < current->element) {
+          current = current->left;
+        }
+        else if (current->element < element) {
+          current = current->right;
+        }
+        else {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // Returns the successor of the specified element
+    T successor(const T &element) const {
+      const SnapNode<T> *found = nullptr;
+      const SnapNode<T> *current = m_root;
+      while (current != nullptr) {
+        if (element < current->element) {
+          found = current;
+          current = current->left;
+        }
+        else {
+          current = current->right;
+        }
+      }
+      if (found == nullptr) {
+        throw std::out_of_range("There is no successor");
+      }
+      return found->element;
+    }
+
+    // Returns the maximum element
+    T max() const {
+      if (m_root == nullptr) {
+        throw std::out_of_range("Tree is empty");
+      }
+      const SnapNode<T> *current = m_root;
+      while (current->right != nullptr) current = current->right;
+      return current->element;
+    }
+
+    // Returns the minimum element
+    T min() const {
+      if (m_root == nullptr) {
+        throw std::out_of_range("Tree is empty");
+      }
+      const SnapNode<T> *current = m_root;
+      while (current->left != nullptr) current = current->left;
+      return current->element;
+    }
+
+    // Returns the height of the snapshot
+    int height() const { return ConcurrentTree<T>::height(m_root); }
+
+  private:
+    Slot *m_slot;
+    const SnapNode<T> *m_root;
+  };
+
+  // Constructs an empty tree
+  ConcurrentTree()
+      : m_root{nullptr}, m_size{0}, m_epoch{0}, m_retired{nullptr, nullptr, nullptr}, m_retired_epoch{0, 0, 0},
+        m_retired_since_reclaim{0} {}
+
+  // Destructor, must not race with any other operation or outlive a snapshot
+  ~ConcurrentTree() {
+    postClear(m_root.load());
+    for (size_t list = 0; list < 3; list++) {
+      freeRetired(m_retired[list]);
+    }
+  }
+
+  ConcurrentTree(const ConcurrentTree<T> &) = delete;
+  ConcurrentTree<T> &operator=(const ConcurrentTree<T> &) = delete;
+
+  // Takes a snapshot for several queries against the same tree
+  Snapshot snapshot() { return Snapshot(*this); }
+
+  // Checks whether the tree is empty
+  bool empty() const { return m_root.load() == nullptr; }
+
+  // Returns the number of elements in the latest published tree
+  size_t size() const { return m_size.load(); }
+
+  // Inserts the specified element, ignoring duplicates. Readers keep seeing
+  // the previous tree until the new root is published.
+  void insert(const T &element) {
+    std::lock_guard<std::mutex> guard(m_writer);
+    SnapNode<T> *root = m_root.load();
+    CopiedPath path;
+    SnapNode<T> *newRoot;
+    try {
+      newRoot = insertCopy(root, element, path);
+    } catch (...) {
+      for (int i = 0; i < path.freshCount; i++) {
+        delete path.fresh[i];
+      }
+      throw;
+    }
+    if (newRoot == root) {
+      return;
+    }
+    m_size++;
+    m_root.store(newRoot);
+    for (int i = 0; i < path.replacedCount; i++) {
+      retire(path.replaced[i]);
+    }
+    reclaim();
+  }
+
+  // Single-query shorthands, each on its own snapshot
+  bool contains(const T &element) { return snapshot().contains(element); }
+  T successor(const T &element) { return snapshot().successor(element); }
+  T max() { return snapshot().max(); }
+  T min() { return snapshot().min(); }
+  int height() { return snapshot().height(); }
+};
+
+#endif
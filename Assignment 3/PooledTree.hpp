@@ -0,0 +1,335 @@
+#pragma once
+#ifndef POOLED_TREE_H
+#define POOLED_TREE_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Node of a PooledTree. Children are 31-bit indices into the tree's arena;
+// the top bit of each marks that side as the taller one, which is all the
+// balance information AVL needs. A PoolNode<int> is 12 bytes.
+template <typename T> struct PoolNode {
+  T element;
+  uint32_t child[2]; // left, right
+};
+
+// AVL tree like Tree<T> whose nodes live in one contiguous arena (a vector)
+// and link to each other by 32-bit index instead of by pointer. There is no
+// allocation per node, no per-node height, size or parent, and the whole
+// arena is freed in one step. Nodes are never removed, so this suits trees
+// that are only built up and read.
+template <typename T> class PooledTree {
+private:
+  static const uint32_t INDEX_MASK = 0x7FFFFFFF;
+  static const uint32_t HEAVY_BIT = 0x80000000;
+  static const uint32_t NIL = INDEX_MASK; // no child
+  static const int MAX_HEIGHT = 48;       // an AVL tree of 2^31 nodes is under 45 high
+
+  std::vector<PoolNode<T>> m_nodes;
+  uint32_t m_root;
+
+  uint32_t left(uint32_t node) const { return m_nodes[node].child[0] & INDEX_MASK; }
+  uint32_t right(uint32_t node) const { return m_nodes[node].child[1] & INDEX_MASK; }
+  void setLeft(uint32_t node, uint32_t child) { m_nodes[node].child[0] = (m_nodes[node].child[0] & HEAVY_BIT) | child; }
+  void setRight(uint32_t node, uint32_t child) { m_nodes[node].child[1] = (m_nodes[node].child[1] & HEAVY_BIT) | child; }
+
+  void link(uint32_t parent, bool isLeft, uint32_t child) {
+    if (isLeft) {
+      setLeft(parent, child);
+    }
+    else {
+      setRight(parent, child);
+    }
+  }
+
+  // Height of the left subtree minus the right one: -1, 0 or 1
+  int balance(uint32_t node) const {
+    return int(m_nodes[node].child[0] >> 31) - int(m_nodes[node].child[1] >> 31);
+  }
+  void setBalance(uint32_t node, int balance) {
+    m_nodes[node].child[0] = (m_nodes[node].child[0] & INDEX_MASK) | (balance > 0 ? HEAVY_BIT : 0);
+    m_nodes[node].child[1] = (m_nodes[node].child[1] & INDEX_MASK) | (balance < 0 ? HEAVY_BIT : 0);
+  }
+
+  // Rotations only relink, the caller sets the balance fields
+  uint32_t rightRotate(uint32_t current) {
+    uint32_t child = left(current);
+    setLeft(current, right(child));
+    setRight(child, current);
+    return child;
+  }
+
+  uint32_t leftRotate(uint32_t current) {
+    uint32_t child = right(current);
+    setRight(current, left(child));
+    setLeft(child, current);
+    return child;
+  }
+
+  // Rebalances a node whose left side got 2 taller; returns the subtree's new root
+  uint32_t fixLeftHeavy(uint32_t current) {
+    uint32_t child = left(current);
+    if (balance(child) > 0) { // Left-Left
+      setBalance(current, 0);
+      setBalance(child, 0);
+      return rightRotate(current);
+    }
+    // Left-Right
+    uint32_t grandchild = right(child);
+    int grandBalance = balance(grandchild);
+    setLeft(current, leftRotate(child));
+    uint32_t root = rightRotate(current);
+    setBalance(current, grandBalance > 0 ? -1 : 0);
+    setBalance(child, grandBalance < 0 ? 1 : 0);
+    setBalance(root, 0);
+    return root;
+  }
+
+  // Rebalances a node whose right side got 2 taller; returns the subtree's new root
+  uint32_t fixRightHeavy(uint32_t current) {
+    uint32_t child = right(current);
+    if (balance(child) < 0) { // Right-Right
+      setBalance(current, 0);
+      setBalance(child, 0);
+      return leftRotate(current);
+    }
+    // Right-Left
+    uint32_t grandchild = left(child);
+    int grandBalance = balance(grandchild);
+    setRight(current, rightRotate(child));
+    uint32_t root = leftRotate(current);
+    setBalance(current, grandBalance < 0 ? 1 : 0);
+    setBalance(child, grandBalance > 0 ? -1 : 0);
+    setBalance(root, 0);
+    return root;
+  }
+
+  // Appends the nodes of the subtree at node that lie within levels levels
+  // of it, in van Emde Boas order: the top half of the levels first, then
+  // each subtree hanging below it, each laid out the same way recursively
+  void vebOrder(uint32_t node, int levels, std::vector<uint32_t> &order) const {
+    if (levels == 1) {
+      order.push_back(node);
+      return;
+    }
+    int topLevels = levels / 2;
+    vebOrder(node, topLevels, order);
+    std::vector<uint32_t> bottoms;
+    collectAtDepth(node, topLevels, bottoms);
+    for (uint32_t bottom : bottoms) {
+      vebOrder(bottom, levels - topLevels, order);
+    }
+  }
+
+  // Appends the nodes depth levels below node, left to right
+  void collectAtDepth(uint32_t node, int depth, std::vector<uint32_t> &out) const {
+    if (node == NIL) return;
+    if (depth == 0) {
+      out.push_back(node);
+      return;
+    }
+    collectAtDepth(left(node), depth - 1, out);
+    collectAtDepth(right(node), depth - 1, out);
+  }
+
+
+public:
+  // Constructor
+  PooledTree() : m_root{NIL} {}
+
+  // Copies and destruction are the arena's: indices stay valid in a copy,
+  // and the destructor frees every node in one step
+  PooledTree(const PooledTree<T> &other) = default;
+  PooledTree<T> &operator=(const PooledTree<T> &other) = default;
+
+  // Move constructor, leaves other empty
+  PooledTree(PooledTree<T> &&other) noexcept : m_nodes{std::move(other.m_nodes)}, m_root{other.m_root} {
+    other.m_nodes.clear();
+    other.m_root = NIL;
+  }
+
+  // Move assignment, leaves other empty
+  PooledTree<T> &operator=(PooledTree<T> &&other) noexcept {
+    if (this == &other) return *this;
+    m_nodes = std::move(other.m_nodes);
+    m_root = other.m_root;
+    other.m_nodes.clear();
+    other.m_root = NIL;
+    return *this;
+  }
+
+  // Reserves arena space for count elements
+  void reserve(size_t count) { m_nodes.reserve(count); }
+
+  // Checks whether the tree is empty
+  bool empty() const { return m_nodes.empty(); }
+
+  // Returns the number of elements
+  size_t size() const { return m_nodes.size(); }
+
+  // Bytes held by the arena
+  size_t memory_bytes() const { return m_nodes.capacity() * sizeof(PoolNode<T>); }
+
+  // Rewrites the arena in van Emde Boas order, so every subtree of a few
+  // levels shares a cache line or page and a lookup touches O(log_B n)
+  // lines instead of O(log n), and drops the arena's spare capacity. Worth
+  // it once a tree is built.
+  void compact() {
+    if (empty()) {
+      clear();
+      return;
+    }
+    std::vector<uint32_t> order;
+    order.reserve(m_nodes.size());
+    vebOrder(m_root, height() + 1, order);
+    std::vector<uint32_t> newIndex(m_nodes.size());
+    for (size_t i = 0; i < order.size(); i++) {
+      newIndex[order[i]] = static_cast<uint32_t>(i);
+    }
+    std::vector<PoolNode<T>> nodes;
+    nodes.reserve(m_nodes.size());
+    for (uint32_t old : order) {
+      PoolNode<T> &node = m_nodes[old];
+      for (uint32_t &child : node.child) {
+        if ((child & INDEX_MASK) != NIL) {
+          child = (child & HEAVY_BIT) | newIndex[child & INDEX_MASK];
+        }
+      }
+      nodes.push_back(std::move(node));
+    }
+    m_nodes.swap(nodes);
+    m_root = 0;
+  }
+
+  // Removes every element and releases the arena
+  void clear() {
+    std::vector<PoolNode<T>>().swap(m_nodes);
+    m_root = NIL;
+  }
+
+  // Returns the height of the tree, O(log n) by following the taller side
+  int height() const {
+    int result = -1;
+    for (uint32_t node = m_root; node != NIL; node = balance(node) < 0 ? right(node) : left(node)) {
+      result++;
+    }
+    return result;
+  }
+
+  // Inserts the specified element, ignoring duplicates
+  void insert(T element) {
+    uint32_t path[MAX_HEIGHT + 1];
+    bool wentLeft[MAX_HEIGHT + 1];
+    int depth = 0;
+    for (uint32_t node = m_root; node != NIL;) {
+      if (element < m_nodes[node].element) {
+        path[depth] = node;
+        wentLeft[depth++] = true;
+        node = left(node);
+      }
+      else if (m_nodes[node].element < element) {
+        path[depth] = node;
+        wentLeft[depth++] = false;
+        node = right(node);
+      }
+      else {
+        return;
+      }
+    }
+    if (m_nodes.size() >= NIL) {
+      throw std::length_error("PooledTree is full");
+    }
+    if (m_nodes.size() == m_nodes.capacity()) {
+      // grow by an eighth rather than letting the vector double, so the
+      // arena stays within about 12.5% of its nodes without compact()
+      m_nodes.reserve(m_nodes.size() + m_nodes.size() / 8 + 16);
+    }
+    uint32_t added = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(PoolNode<T>{element, {NIL, NIL}});
+
+    if (depth == 0) {
+      m_root = added;
+      return;
+    }
+    link(path[depth - 1], wentLeft[depth - 1], added);
+
+    // walk up: a node that becomes balanced stops the height change, one
+    // that goes 2 out of balance is rotated back to its old height
+    while (depth-- > 0) {
+      uint32_t node = path[depth];
+      int newBalance = balance(node) + (wentLeft[depth] ? 1 : -1);
+      if (newBalance == 0) {
+        setBalance(node, 0);
+        return;
+      }
+      if (newBalance == 1 || newBalance == -1) {
+        setBalance(node, newBalance);
+        continue;
+      }
+      uint32_t subtree = newBalance > 0 ? fixLeftHeavy(node) : fixRightHeavy(node);
+      if (depth == 0) {
+        m_root = subtree;
+      }
+      else {
+        link(path[depth - 1], wentLeft[depth - 1], subtree);
+      }
+      return;
+    }
+  }
+
+  // Checks whether the container contains the specified element
+  bool contains(T element) const {
+    const PoolNode<T> *nodes = m_nodes.data();
+    uint32_t node = m_root;
+    while (node != NIL) {
+      const PoolNode<T> &current = nodes[node];
+      bool goRight = current.element < element;
+      if (!goRight && !(element < current.element)) return true;
+      node = current.child[goRight] & INDEX_MASK; // indexed, so the descent doesn't branch on the key
+    }
+    return false;
+  }
+
+  // Returns the maximum element
+  T max() const {
+    if (empty()) {
+      throw std::out_of_range("Tree is empty");
+    }
+    uint32_t node = m_root;
+    while (right(node) != NIL) node = right(node);
+    return m_nodes[node].element;
+  }
+
+  // Returns the minimum element
+  T min() const {
+    if (empty()) {
+      throw std::out_of_range("Tree is empty");
+    }
+    uint32_t node = m_root;
+    while (left(node) != NIL) node = left(node);
+    return m_nodes[node].element;
+  }
+
+  // Returns the successor of the specified element
+  T successor(T element) const {
+    uint32_t found = NIL;
+    uint32_t node = m_root;
+    while (node != NIL) {
+      if (element < m_nodes[node].element) {
+        found = node;
+        node = left(node);
+      }
+      else {
+        node = right(node);
+      }
+    }
+    if (found == NIL) {
+      throw std::out_of_range("There is no successor");
+    }
+    return m_nodes[found].element;
+  }
+};
+
+#endif